@@ -0,0 +1,37 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Read-only pointer and count over memory owned elsewhere, like a std::vector or a mapped file
+template <typename T>
+class ArrayView
+{
+public:
+    ArrayView() = default;
+
+    ArrayView(const T* data, size_t size)
+        : _data(data), _size(size)
+    {
+    }
+
+    ArrayView(const std::vector<T>& vector)
+        : _data(vector.data()), _size(vector.size())
+    {
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const T* data() const { return _data; }
+    const T& operator[](size_t i) const { return _data[i]; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+private:
+    const T* _data = nullptr;
+    size_t _size = 0;
+};
\ No newline at end of file
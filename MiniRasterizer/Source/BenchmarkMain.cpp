@@ -0,0 +1,625 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+// Pipeline benchmark suite.
+// Micro: each RenderPipeline stage timed in isolation on pre-built inputs.
+// Macro: whole frames over parameterized scenes (sphere segments, object count, resolution, shader).
+// Atlas: one thumbnail per material on a shared sphere, over the object count sweep.
+// Cull: scene BVH frustum queries over large object counts of which only a few are in view.
+// Results are written as JSON so runs from different versions can be diffed.
+
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#include "RenderPipeline.h"
+#include "JobSystem.h"
+#include "SceneDescription.h"
+#include "MeshGenerator.h"
+#include "Scene.h"
+
+namespace
+{
+    struct BenchmarkOptions
+    {
+        int iterations = 5;
+        int warmup = 1;
+        bool isQuick = false;
+        std::string outputPath; // Empty writes to stdout
+        std::string filter;
+        int threadCount = 0; // 0 uses every hardware thread
+    };
+
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string kind;   // "stage", "frame", "atlas", "cull" or "post"
+        std::string stage;  // Stage name, or "frame"
+        std::string shader;
+        unsigned int segments = 0;
+        int objects = 0;
+        int width = 0;
+        int height = 0;
+        size_t items = 0;   // Work items per iteration (vertices, triangles, fragments, pixels)
+        std::vector<double> samplesMs;
+    };
+
+    struct SceneParameters
+    {
+        std::string shader = "blinnphong";
+        unsigned int segments = 64;
+        int objects = 1;
+        int width = 1280;
+        int height = 720;
+    };
+
+    // Runs body warmup + iterations times, recording the timed iterations
+    std::vector<double> Measure(const BenchmarkOptions& options, const std::function<void()>& setup, const std::function<void()>& body)
+    {
+        std::vector<double> samples;
+        for (int i = 0; i < options.warmup + options.iterations; ++i)
+        {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            if (i >= options.warmup)
+            {
+                samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            }
+        }
+        return samples;
+    }
+
+    // Lays the objects out on a square grid that fills the default camera's view
+    SceneDescription CreateSceneDescription(const SceneParameters& params)
+    {
+        SceneDescription description;
+        description.width = params.width;
+        description.height = params.height;
+
+        int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(params.objects))));
+        float spacing = 10.0f / gridSize;
+        for (int i = 0; i < params.objects; ++i)
+        {
+            SphereDescription sphere;
+            sphere.segments = params.segments;
+            sphere.shaderName = params.shader;
+            if (params.objects == 1)
+            {
+                sphere.radius = 3.0f;
+            }
+            else
+            {
+                sphere.radius = spacing * 0.4f;
+                sphere.position = Vec3(
+                    (i % gridSize + 0.5f) * spacing - 5.0f,
+                    (i / gridSize + 0.5f) * spacing - 5.0f,
+                    0.0f);
+            }
+            description.spheres.push_back(sphere);
+        }
+        return description;
+    }
+
+    std::string DescribeScene(const SceneParameters& params)
+    {
+        std::ostringstream name;
+        name << params.shader << "/segments=" << params.segments << "/objects=" << params.objects
+            << "/" << params.width << "x" << params.height;
+        return name.str();
+    }
+
+    // Names look like "stage/raster/toon/segments=64/objects=1/1280x720" or "frame/toon/..."
+    BenchmarkResult CreateResult(const std::string& kind, const std::string& stage, const SceneParameters& params)
+    {
+        BenchmarkResult result;
+        result.name = (kind == stage ? kind : kind + "/" + stage) + "/" + DescribeScene(params);
+        result.kind = kind;
+        result.stage = stage;
+        result.shader = params.shader;
+        result.segments = params.segments;
+        result.objects = params.objects;
+        result.width = params.width;
+        result.height = params.height;
+        return result;
+    }
+
+    bool IsSelected(const BenchmarkOptions& options, const std::string& name)
+    {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+}
+
+// Friend of RenderPipeline, so it can drive the private stages directly
+class PipelineBenchmark
+{
+public:
+    static void RunStageBenchmarks(const BenchmarkOptions& options, const SceneParameters& params, std::vector<BenchmarkResult>& results)
+    {
+        SceneDescription description = CreateSceneDescription(params);
+        LoadedScene scene = BuildScene(description);
+        const auto& object = scene.objects.front();
+        const MeshData& mesh = *object->GetMesh();
+
+        RenderPipeline pipeline(params.width, params.height);
+        pipeline.SetCamera(description.CreateCamera());
+        pipeline.SetLight(description.light);
+        pipeline.BindMaterial(object->GetMaterial().get());
+
+        // Build each stage's input once by running the stages in order.
+        // The arena is never reset here; cleared scratch outputs reuse their storage across iterations.
+        FrameArena arena;
+        ArenaVector<VertexOutput> vertices(arena);
+        ArenaVector<TrianglePrimitive> triangles(arena);
+        ArenaVector<Fragment> fragments(arena);
+        ArenaVector<PixelData> pixels(arena);
+        pipeline._RunVertexProcessing(mesh, object->GetPosition(), vertices);
+        pipeline._RunTriangleProcessing(vertices, mesh, triangles);
+        pipeline._RunRasterization(triangles.data(), triangles.size(), fragments);
+        pipeline._RunFragmentProcessing(fragments, pixels);
+
+        ArenaVector<VertexOutput> vertexScratch(arena);
+        ArenaVector<TrianglePrimitive> triangleScratch(arena);
+        ArenaVector<Fragment> fragmentScratch(arena);
+        ArenaVector<PixelData> pixelScratch(arena);
+
+        BenchmarkResult vertex = CreateResult("stage", "vertex", params);
+        if (IsSelected(options, vertex.name))
+        {
+            vertex.items = mesh.GetVertexCount();
+            vertex.samplesMs = Measure(options,
+                [&]() { vertexScratch.clear(); },
+                [&]() { pipeline._RunVertexProcessing(mesh, object->GetPosition(), vertexScratch); });
+            results.push_back(vertex);
+        }
+
+        BenchmarkResult triangle = CreateResult("stage", "triangle", params);
+        if (IsSelected(options, triangle.name))
+        {
+            triangle.items = mesh.GetIndexCount() / 3;
+            triangle.samplesMs = Measure(options,
+                [&]() { triangleScratch.clear(); },
+                [&]() { pipeline._RunTriangleProcessing(vertices, mesh, triangleScratch); });
+            results.push_back(triangle);
+        }
+
+        BenchmarkResult raster = CreateResult("stage", "raster", params);
+        if (IsSelected(options, raster.name))
+        {
+            raster.items = triangles.size();
+            raster.samplesMs = Measure(options,
+                [&]() { fragmentScratch.clear(); },
+                [&]() { pipeline._RunRasterization(triangles.data(), triangles.size(), fragmentScratch); });
+            results.push_back(raster);
+        }
+
+        BenchmarkResult fragment = CreateResult("stage", "fragment", params);
+        if (IsSelected(options, fragment.name))
+        {
+            fragment.items = fragments.size();
+            fragment.samplesMs = Measure(options,
+                [&]() { pixelScratch.clear(); },
+                [&]() { pipeline._RunFragmentProcessing(fragments, pixelScratch); });
+            results.push_back(fragment);
+        }
+
+        // Same fragments with a trilinear base color texture, the difference to "fragment" is the sampling cost
+        BenchmarkResult texturedFragment = CreateResult("stage", "fragment-textured", params);
+        if (IsSelected(options, texturedFragment.name))
+        {
+            IShaderProperties* properties = object->GetMaterial()->GetProperties();
+            properties->SetBaseColorTexture(Texture::CreateCheckerboard(1024, 16, Vec3(1.0f, 1.0f, 1.0f), Vec3(0.2f, 0.2f, 0.2f)));
+            texturedFragment.items = fragments.size();
+            texturedFragment.samplesMs = Measure(options,
+                [&]() { pixelScratch.clear(); },
+                [&]() { pipeline._RunFragmentProcessing(fragments, pixelScratch); });
+            properties->SetBaseColorTexture(nullptr);
+            results.push_back(texturedFragment);
+        }
+
+        BenchmarkResult framebuffer = CreateResult("stage", "framebuffer", params);
+        if (IsSelected(options, framebuffer.name))
+        {
+            framebuffer.items = pixels.size();
+            framebuffer.samplesMs = Measure(options,
+                [&]() { pipeline.ClearBuffers(); },
+                [&]() { pipeline._RunFramebufferOperations(pixels); });
+            results.push_back(framebuffer);
+        }
+
+        // Same pixels depth tested from every job system thread into packed 64-bit words
+        BenchmarkResult atomicFramebuffer = CreateResult("stage", "framebuffer-atomic", params);
+        if (IsSelected(options, atomicFramebuffer.name))
+        {
+            pipeline.SetPixelStorage(PixelStorage::PackedAtomic);
+            atomicFramebuffer.items = pixels.size();
+            atomicFramebuffer.samplesMs = Measure(options,
+                [&]() { pipeline.ClearBuffers(); },
+                [&]() { pipeline._RunFramebufferOperations(pixels); });
+            pipeline.SetPixelStorage(PixelStorage::Separate);
+            results.push_back(atomicFramebuffer);
+        }
+    }
+
+    static void RunFrameBenchmark(const BenchmarkOptions& options, const SceneParameters& params, std::vector<BenchmarkResult>& results)
+    {
+        BenchmarkResult frame = CreateResult("frame", "frame", params);
+        if (!IsSelected(options, frame.name))
+        {
+            return;
+        }
+
+        SceneDescription description = CreateSceneDescription(params);
+        LoadedScene scene = BuildScene(description);
+
+        RenderPipeline pipeline(params.width, params.height);
+        pipeline.SetCamera(description.CreateCamera());
+        pipeline.SetLight(description.light);
+
+        size_t triangleCount = 0;
+        for (const auto& obj : scene.objects)
+        {
+            triangleCount += obj->GetMesh()->GetIndexCount() / 3;
+        }
+        frame.items = triangleCount;
+
+        frame.samplesMs = Measure(options,
+            []() {},
+            [&]()
+            {
+                pipeline.ClearBuffers();
+                for (const auto& obj : scene.objects)
+                {
+                    pipeline.BindMaterial(obj->GetMaterial().get());
+                    pipeline.Draw(*(obj->GetMesh()), obj->GetPosition());
+                }
+                pipeline.GetFinalColorBuffer();
+            });
+        results.push_back(frame);
+    }
+
+    // One thumbnail per object's material on a shared sphere, width x height per cell
+    static void RunAtlasBenchmark(const BenchmarkOptions& options, const SceneParameters& params, std::vector<BenchmarkResult>& results)
+    {
+        BenchmarkResult atlas = CreateResult("atlas", "atlas", params);
+        if (!IsSelected(options, atlas.name))
+        {
+            return;
+        }
+
+        SceneDescription description = CreateSceneDescription(params);
+        LoadedScene scene = BuildScene(description);
+        std::vector<const Material*> materials;
+        for (const auto& obj : scene.objects)
+        {
+            materials.push_back(obj->GetMaterial().get());
+        }
+        auto mesh = MeshGenerator::CreateSphere(3.0f, params.segments, Vec3(0, 0, 0));
+        int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(materials.size()))));
+
+        RenderPipeline pipeline(params.width, params.height);
+        pipeline.SetCamera(Camera(description.cameraPosition, Vec3(0.0f, 0.0f, -1.0f), description.cameraFov, 1.0f));
+        pipeline.SetLight(description.light);
+
+        atlas.items = materials.size();
+        atlas.samplesMs = Measure(options,
+            [&]() { pipeline.ClearBuffers(); },
+            [&]() { pipeline.RenderMaterialAtlas(*mesh, Vec3(0, 0, 0), materials, params.width, params.height, columns); });
+        results.push_back(atlas);
+    }
+
+    // Objects on a square grid with 10 units between neighbours; the default camera sees the few around the origin
+    static void RunCullBenchmark(const BenchmarkOptions& options, const SceneParameters& params, std::vector<BenchmarkResult>& results)
+    {
+        BenchmarkResult cull = CreateResult("cull", "cull", params);
+        if (!IsSelected(options, cull.name))
+        {
+            return;
+        }
+
+        SceneDescription description = CreateSceneDescription(SceneParameters());
+        LoadedScene scene = BuildScene(description);
+        const std::shared_ptr<RenderableObject>& prototype = scene.objects.front();
+
+        Scene sceneTree;
+        int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(params.objects))));
+        for (int i = 0; i < params.objects; ++i)
+        {
+            Vec3 position((i % gridSize - gridSize / 2) * 10.0f, (i / gridSize - gridSize / 2) * 10.0f, 0.0f);
+            sceneTree.Add(std::make_shared<RenderableObject>(prototype->GetMesh(), prototype->GetMaterial(), position));
+        }
+
+        Camera camera = description.CreateCamera();
+        std::vector<SceneObjectId> visible;
+        cull.items = params.objects;
+        cull.samplesMs = Measure(options,
+            []() {},
+            [&]() { sceneTree.QueryFrustum(camera, visible); });
+        results.push_back(cull);
+    }
+
+    // The display stage alone over one rendered frame; stage names the settings, e.g. "aces-srgb-fxaa"
+    static void RunPostBenchmark(
+        const BenchmarkOptions& options,
+        const SceneParameters& params,
+        const std::string& stage,
+        const PostProcessSettings& settings,
+        std::vector<BenchmarkResult>& results)
+    {
+        BenchmarkResult post = CreateResult("post", stage, params);
+        if (!IsSelected(options, post.name))
+        {
+            return;
+        }
+
+        SceneDescription description = CreateSceneDescription(params);
+        LoadedScene scene = BuildScene(description);
+        RenderPipeline pipeline(params.width, params.height);
+        pipeline.SetCamera(description.CreateCamera());
+        pipeline.SetLight(description.light);
+        pipeline.SetPostProcess(settings);
+        pipeline.ClearBuffers();
+        for (const auto& obj : scene.objects)
+        {
+            pipeline.BindMaterial(obj->GetMaterial().get());
+            pipeline.Draw(*(obj->GetMesh()), obj->GetPosition());
+        }
+        pipeline.GetFinalColorBuffer();
+
+        std::vector<uint8_t> pixels;
+        post.items = static_cast<size_t>(params.width) * params.height;
+        post.samplesMs = Measure(options,
+            []() {},
+            [&]() { pipeline.ResolveDisplayPixels(pixels); });
+        results.push_back(post);
+    }
+};
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout <<
+            "Usage: MiniRasterizerBenchmark [options]\n"
+            "  --iterations <N>   Timed iterations per benchmark (default 5)\n"
+            "  --warmup <N>       Untimed iterations before measuring (default 1)\n"
+            "  --quick            Smaller sweeps for a fast smoke run\n"
+            "  --filter <text>    Only run benchmarks whose name contains text\n"
+            "  --output <path>    Write the JSON report to a file instead of stdout\n"
+            "  --threads <N>      Threads for the parallel stages (default: all cores)\n";
+    }
+
+    bool ParseArguments(int argc, char** argv, BenchmarkOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                PrintUsage();
+                return false;
+            }
+            if (arg == "--quick")
+            {
+                options.isQuick = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value for argument '" + arg + "'.");
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--iterations") { options.iterations = std::max(1, std::stoi(value)); }
+            else if (arg == "--warmup") { options.warmup = std::max(0, std::stoi(value)); }
+            else if (arg == "--filter") { options.filter = value; }
+            else if (arg == "--output") { options.outputPath = value; }
+            else if (arg == "--threads") { options.threadCount = std::max(0, std::stoi(value)); }
+            else { throw std::runtime_error("Unknown argument '" + arg + "', see --help."); }
+        }
+        return true;
+    }
+
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    void WriteJson(std::ostream& out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results)
+    {
+        out << "{\n";
+        out << "  \"schema\": 1,\n";
+        out << "  \"iterations\": " << options.iterations << ",\n";
+        out << "  \"warmup\": " << options.warmup << ",\n";
+        out << "  \"threads\": " << JobSystem::GetThreadCount() << ",\n";
+#if defined(_MSC_VER)
+        out << "  \"compiler\": \"msvc " << _MSC_VER << "\",\n";
+#elif defined(__clang__)
+        out << "  \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+        out << "  \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#else
+        out << "  \"compiler\": \"unknown\",\n";
+#endif
+#if defined(NDEBUG)
+        out << "  \"optimized\": true,\n";
+#else
+        out << "  \"optimized\": false,\n";
+#endif
+        out << "  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchmarkResult& result = results[i];
+            std::vector<double> sorted = result.samplesMs;
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (double sample : sorted)
+            {
+                sum += sample;
+            }
+            double mean = sum / sorted.size();
+            double median = sorted[sorted.size() / 2];
+            double itemsPerSecond = median > 0.0 ? result.items / (median / 1000.0) : 0.0;
+
+            out << "    {";
+            out << "\"name\": \"" << EscapeJson(result.name) << "\", ";
+            out << "\"kind\": \"" << result.kind << "\", ";
+            out << "\"stage\": \"" << result.stage << "\", ";
+            out << "\"shader\": \"" << EscapeJson(result.shader) << "\", ";
+            out << "\"segments\": " << result.segments << ", ";
+            out << "\"objects\": " << result.objects << ", ";
+            out << "\"width\": " << result.width << ", ";
+            out << "\"height\": " << result.height << ", ";
+            out << "\"items\": " << result.items << ", ";
+            out << "\"min_ms\": " << sorted.front() << ", ";
+            out << "\"median_ms\": " << median << ", ";
+            out << "\"mean_ms\": " << mean << ", ";
+            out << "\"max_ms\": " << sorted.back() << ", ";
+            out << "\"items_per_second\": " << itemsPerSecond;
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n";
+        out << "}\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        BenchmarkOptions options;
+        if (!ParseArguments(argc, argv, options))
+        {
+            return 0;
+        }
+        JobSystem::SetThreadCount(options.threadCount);
+
+        const std::vector<std::string> shaders = { "blinnphong", "toon" };
+        std::vector<unsigned int> segmentSweep = { 8, 16, 32, 64, 128, 256, 512 };
+        std::vector<int> objectSweep = { 1, 10, 100, 1000, 10000 };
+        std::vector<std::pair<int, int>> resolutionSweep = { { 854, 480 }, { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+        if (options.isQuick)
+        {
+            segmentSweep = { 8, 64 };
+            objectSweep = { 1, 100 };
+            resolutionSweep = { { 854, 480 }, { 1280, 720 } };
+        }
+
+        std::vector<BenchmarkResult> results;
+        for (const std::string& shader : shaders)
+        {
+            SceneParameters defaults;
+            defaults.shader = shader;
+
+            std::cerr << "[" << shader << "] stage benchmarks\n";
+            for (unsigned int segments : segmentSweep)
+            {
+                SceneParameters params = defaults;
+                params.segments = segments;
+                PipelineBenchmark::RunStageBenchmarks(options, params, results);
+            }
+
+            std::cerr << "[" << shader << "] frame benchmarks: segments\n";
+            for (unsigned int segments : segmentSweep)
+            {
+                SceneParameters params = defaults;
+                params.segments = segments;
+                PipelineBenchmark::RunFrameBenchmark(options, params, results);
+            }
+
+            std::cerr << "[" << shader << "] frame benchmarks: objects\n";
+            for (int objects : objectSweep)
+            {
+                SceneParameters params = defaults;
+                params.objects = objects;
+                params.segments = 16;
+                PipelineBenchmark::RunFrameBenchmark(options, params, results);
+            }
+
+            std::cerr << "[" << shader << "] frame benchmarks: resolution\n";
+            for (const auto& resolution : resolutionSweep)
+            {
+                SceneParameters params = defaults;
+                params.width = resolution.first;
+                params.height = resolution.second;
+                PipelineBenchmark::RunFrameBenchmark(options, params, results);
+            }
+
+            std::cerr << "[" << shader << "] atlas benchmarks\n";
+            for (int objects : objectSweep)
+            {
+                SceneParameters params = defaults;
+                params.objects = objects;
+                params.width = 128;
+                params.height = 128;
+                PipelineBenchmark::RunAtlasBenchmark(options, params, results);
+            }
+        }
+
+        std::cerr << "cull benchmarks\n";
+        for (int objects : { 1000, 10000, 100000 })
+        {
+            SceneParameters params;
+            params.objects = objects;
+            PipelineBenchmark::RunCullBenchmark(options, params, results);
+        }
+
+        std::cerr << "post-process benchmarks\n";
+        {
+            SceneParameters params;
+            params.width = 1920;
+            params.height = 1080;
+            PostProcessSettings settings;
+            PipelineBenchmark::RunPostBenchmark(options, params, "clamp", settings, results);
+            settings.tonemapper = Tonemapper::ACES;
+            settings.isSrgbEncoded = true;
+            PipelineBenchmark::RunPostBenchmark(options, params, "aces-srgb", settings, results);
+            settings.isFxaaEnabled = true;
+            PipelineBenchmark::RunPostBenchmark(options, params, "aces-srgb-fxaa", settings, results);
+        }
+
+        if (options.outputPath.empty())
+        {
+            WriteJson(std::cout, options, results);
+        }
+        else
+        {
+            std::ofstream file(options.outputPath);
+            if (!file)
+            {
+                throw std::runtime_error("Cannot open '" + options.outputPath + "' for writing.");
+            }
+            WriteJson(file, options, results);
+            std::cerr << "wrote " << results.size() << " results to " << options.outputPath << "\n";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -7,8 +7,6 @@
 #include "IShaderProperties.h"
 #include "Vec3.h"
 #include <string>
-#include <map>
-#include <utility>
 
 struct BlinnPhongProperties : public IShaderProperties
 {
@@ -18,21 +16,22 @@ struct BlinnPhongProperties : public IShaderProperties
     float smoothness{ 32.0f };
 
     // UI-Driving Methods
-    std::map<std::string, std::pair<float, float>> GetSliderProperties() const override
+    ArrayView<ShaderPropertyDescriptor> GetPropertyDescriptors() const override
     {
-        return
+        static constexpr ShaderPropertyDescriptor DESCRIPTORS[] =
         {
-            {"AmbientX_Red", {0.0f, 1.0f}},
-            {"AmbientY_Green", {0.0f, 1.0f}},
-            {"AmbientZ_Blue", {0.0f, 1.0f}},
-            {"DiffuseX_Red", {0.0f, 1.0f}},
-            {"DiffuseY_Green", {0.0f, 1.0f}},
-            {"DiffuseZ_Blue", {0.0f, 1.0f}},
-            {"SpecularX_Red", {0.0f, 1.0f}},
-            {"SpecularY_Green", {0.0f, 1.0f}},
-            {"SpecularZ_Blue", {0.0f, 1.0f}},
-            {"Smoothness", {1.0f, 64.0f}}
+            _VectorProperty("AmbientX_Red", 0.0f, 1.0f, &BlinnPhongProperties::ambient, &Vec3::x),
+            _VectorProperty("AmbientY_Green", 0.0f, 1.0f, &BlinnPhongProperties::ambient, &Vec3::y),
+            _VectorProperty("AmbientZ_Blue", 0.0f, 1.0f, &BlinnPhongProperties::ambient, &Vec3::z),
+            _VectorProperty("DiffuseX_Red", 0.0f, 1.0f, &BlinnPhongProperties::diffuse, &Vec3::x),
+            _VectorProperty("DiffuseY_Green", 0.0f, 1.0f, &BlinnPhongProperties::diffuse, &Vec3::y),
+            _VectorProperty("DiffuseZ_Blue", 0.0f, 1.0f, &BlinnPhongProperties::diffuse, &Vec3::z),
+            _FloatProperty("Smoothness", 1.0f, 64.0f, &BlinnPhongProperties::smoothness),
+            _VectorProperty("SpecularX_Red", 0.0f, 1.0f, &BlinnPhongProperties::specular, &Vec3::x),
+            _VectorProperty("SpecularY_Green", 0.0f, 1.0f, &BlinnPhongProperties::specular, &Vec3::y),
+            _VectorProperty("SpecularZ_Blue", 0.0f, 1.0f, &BlinnPhongProperties::specular, &Vec3::z)
         };
+        return { DESCRIPTORS, sizeof(DESCRIPTORS) / sizeof(DESCRIPTORS[0]) };
     }
 
     std::string GetShaderName() const override
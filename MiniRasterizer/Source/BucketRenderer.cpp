@@ -0,0 +1,97 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "BucketRenderer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "Frustum.h"
+#include "ImageWriter.h"
+#include "Profiler.h"
+
+namespace
+{
+    // Pixels added around a bucket's frustum, so rounding never drops an object that touches its edge
+    constexpr float FRUSTUM_MARGIN_PIXELS = 1.0f;
+}
+
+BucketRenderer::BucketRenderer(int imageWidth, int imageHeight, int bucketSize)
+    : _imageWidth(imageWidth),
+    _imageHeight(imageHeight),
+    _bucketSize(bucketSize),
+    _pipeline(bucketSize, bucketSize)
+{
+    if (imageWidth <= 0 || imageHeight <= 0 || bucketSize <= 0)
+    {
+        throw std::runtime_error("BucketRenderer: Image and bucket size must be positive.");
+    }
+    _pipeline.SetVertexCacheBudget(DEFAULT_VERTEX_CACHE_BYTES);
+}
+
+void BucketRenderer::Render(const Scene& scene, const std::string& outputPath)
+{
+    PROFILE_SCOPE("BucketRender");
+    if (_pipeline.GetPostProcess().isFxaaEnabled)
+    {
+        throw std::runtime_error("BucketRenderer: FXAA reads pixels across bucket edges and is not supported.");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    _stats = BucketRenderStats();
+    ImageWriter::StreamWriter writer(outputPath, _imageWidth, _imageHeight, ImageWriter::GetImageFormat(outputPath));
+    const Camera camera = _pipeline.GetCamera();
+    const float pixelToNdcX = 2.0f / _imageWidth;
+    const float pixelToNdcY = 2.0f / _imageHeight;
+
+    for (int bucketY = 0; bucketY < _imageHeight; bucketY += _bucketSize)
+    {
+        for (int bucketX = 0; bucketX < _imageWidth; bucketX += _bucketSize)
+        {
+            PROFILE_SCOPE("Bucket");
+            const int width = std::min(_bucketSize, _imageWidth - bucketX);
+            const int height = std::min(_bucketSize, _imageHeight - bucketY);
+            _pipeline.SetImageWindow(_imageWidth, _imageHeight, bucketX, bucketY);
+            _pipeline.ClearBuffers();
+
+            // NDC y points up, image rows go down
+            const Frustum frustum(camera,
+                (bucketX - FRUSTUM_MARGIN_PIXELS) * pixelToNdcX - 1.0f,
+                (bucketX + width + FRUSTUM_MARGIN_PIXELS) * pixelToNdcX - 1.0f,
+                1.0f - (bucketY + height + FRUSTUM_MARGIN_PIXELS) * pixelToNdcY,
+                1.0f - (bucketY - FRUSTUM_MARGIN_PIXELS) * pixelToNdcY);
+            scene.QueryFrustum(frustum, _objects);
+            for (SceneObjectId id : _objects)
+            {
+                const std::shared_ptr<RenderableObject>& obj = scene.Get(id);
+                _pipeline.BindMaterial(obj->GetMaterial().get());
+                _pipeline.Draw(*(obj->GetMesh()), obj->GetPosition());
+            }
+
+            _stats.bucketCount++;
+            _stats.bucketsEmpty += _objects.empty() ? 1 : 0;
+            _stats.objectDraws += _objects.size();
+            _stats.pipeline.Accumulate(_pipeline.GetFrameStatistics());
+
+            // Edge buckets are cut down to the part inside the image
+            _pipeline.ResolveDisplayPixels(_displayPixels);
+            _imagePixels.resize(static_cast<size_t>(width) * height * 3);
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8_t* source = &_displayPixels[static_cast<size_t>(y) * _bucketSize * 4];
+                uint8_t* destination = &_imagePixels[static_cast<size_t>(y) * width * 3];
+                for (int x = 0; x < width; ++x)
+                {
+                    destination[x * 3 + 0] = source[x * 4 + 0];
+                    destination[x * 3 + 1] = source[x * 4 + 1];
+                    destination[x * 3 + 2] = source[x * 4 + 2];
+                }
+            }
+            writer.WriteRect(bucketX, bucketY, width, height, _imagePixels.data());
+        }
+    }
+    writer.Finish();
+    _stats.totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
\ No newline at end of file
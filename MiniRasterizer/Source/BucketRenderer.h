@@ -0,0 +1,68 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "RenderPipeline.h"
+#include "PipelineStatistics.h"
+#include "Scene.h"
+
+struct BucketRenderStats
+{
+    int bucketCount = 0;
+    int bucketsEmpty = 0;        // No object's bounds reached the bucket, it was only cleared and written
+    uint64_t objectDraws = 0;    // An object that spans several buckets is drawn once per bucket
+    PipelineStatistics pipeline; // Summed over the buckets
+    double totalMs = 0.0;
+};
+
+// Renders an image of any size through one bucketSize x bucketSize pipeline, for print-size output that would not
+// fit in memory as full-frame buffers.
+//
+// The image is cut into buckets in row-major order. For each bucket the pipeline is pointed at that window of the
+// image (RenderPipeline::SetImageWindow), the scene BVH is queried with the bucket's slice of the camera frustum,
+// and the objects found are drawn; the rasterizer then skips every triangle whose bounding box misses the bucket.
+// The finished bucket goes through the display stage and straight into the output file (ImageWriter::StreamWriter).
+// Peak memory is the bucket-sized buffers, the frame arena and the vertex cache, whatever the image size; only a
+// PNG also holds one row of buckets, as PNG rows must be written in order.
+class BucketRenderer
+{
+public:
+    static constexpr int DEFAULT_BUCKET_SIZE = 256;
+
+    // Objects spanning several buckets reuse their assembled triangles through it instead of being vertex-shaded
+    // once per bucket
+    static constexpr size_t DEFAULT_VERTEX_CACHE_BYTES = 64 * 1024 * 1024;
+
+    BucketRenderer(int imageWidth, int imageHeight, int bucketSize = DEFAULT_BUCKET_SIZE);
+
+    // Camera, light and every other setting. The camera should have the image's aspect ratio and the render scale
+    // should stay 1.
+    RenderPipeline& GetPipeline() { return _pipeline; }
+
+    // Writes the image as .ppm or .png. Throws std::runtime_error with FXAA enabled, it reads pixels across
+    // bucket edges.
+    void Render(const Scene& scene, const std::string& outputPath);
+
+    const BucketRenderStats& GetStats() const { return _stats; }
+    int GetImageWidth() const { return _imageWidth; }
+    int GetImageHeight() const { return _imageHeight; }
+    int GetBucketSize() const { return _bucketSize; }
+
+private:
+    int _imageWidth;
+    int _imageHeight;
+    int _bucketSize;
+    RenderPipeline _pipeline;
+    BucketRenderStats _stats;
+
+    std::vector<SceneObjectId> _objects;
+    std::vector<uint8_t> _displayPixels; // The bucket as RGBA8
+    std::vector<uint8_t> _imagePixels;   // Its part inside the image as RGB8
+};
\ No newline at end of file
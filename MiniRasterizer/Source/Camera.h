@@ -29,4 +29,19 @@ struct Camera
         farPlane(far)
     {
     }
+
+    bool operator==(const Camera& other) const
+    {
+        return position == other.position &&
+            direction == other.direction &&
+            fov == other.fov &&
+            aspectRatio == other.aspectRatio &&
+            nearPlane == other.nearPlane &&
+            farPlane == other.farPlane;
+    }
+
+    bool operator!=(const Camera& other) const
+    {
+        return !(*this == other);
+    }
 };
\ No newline at end of file
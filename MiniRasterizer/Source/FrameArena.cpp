@@ -0,0 +1,143 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "FrameArena.h"
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+namespace
+{
+    size_t AlignUp(size_t offset, size_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+FrameArena::FrameArena(size_t chunkBytes)
+    : _chunkBytes(std::max<size_t>(chunkBytes, 64))
+{
+}
+
+void FrameArena::SetCeiling(size_t ceilingBytes)
+{
+    _ceilingBytes = ceilingBytes;
+    if (_bytesReserved > _ceilingBytes)
+    {
+        if (_bytesUsed > 0)
+        {
+            throw std::runtime_error("FrameArena: Cannot lower the ceiling below live allocations, call Reset first.");
+        }
+        _ReleaseChunks();
+    }
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+    // Later chunks are empty after a Reset, so the search only ever moves forward
+    while (_currentChunk < _chunks.size())
+    {
+        Chunk& chunk = _chunks[_currentChunk];
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+        size_t offset = AlignUp(base + chunk.used, alignment) - base;
+        if (offset + bytes <= chunk.size)
+        {
+            _bytesUsed += offset + bytes - chunk.used;
+            _highWaterMark = std::max(_highWaterMark, _bytesUsed);
+            chunk.used = offset + bytes;
+            return chunk.data.get() + offset;
+        }
+        if (_currentChunk + 1 == _chunks.size())
+        {
+            break;
+        }
+        ++_currentChunk;
+    }
+
+    _AddChunk(bytes + alignment);
+    return Allocate(bytes, alignment);
+}
+
+bool FrameArena::TryResize(void* ptr, size_t oldBytes, size_t newBytes)
+{
+    if (_currentChunk >= _chunks.size())
+    {
+        return false;
+    }
+
+    Chunk& chunk = _chunks[_currentChunk];
+    unsigned char* bytes = static_cast<unsigned char*>(ptr);
+    if (bytes + oldBytes != chunk.data.get() + chunk.used)
+    {
+        return false;
+    }
+
+    size_t offset = static_cast<size_t>(bytes - chunk.data.get());
+    if (offset + newBytes > chunk.size)
+    {
+        return false;
+    }
+
+    _bytesUsed = _bytesUsed - oldBytes + newBytes;
+    _highWaterMark = std::max(_highWaterMark, _bytesUsed);
+    chunk.used = offset + newBytes;
+    return true;
+}
+
+void FrameArena::Reset()
+{
+    // One chunk keeps every allocation contiguous, so in-place growth works next frame
+    if (_chunks.size() > 1)
+    {
+        size_t totalBytes = _bytesReserved;
+        _ReleaseChunks();
+        _AddChunk(totalBytes);
+    }
+    for (Chunk& chunk : _chunks)
+    {
+        chunk.used = 0;
+    }
+    _currentChunk = 0;
+    _bytesUsed = 0;
+    ++_generation;
+    ++_resetCount;
+}
+
+FrameArenaStats FrameArena::GetStats() const
+{
+    FrameArenaStats stats;
+    stats.bytesUsed = _bytesUsed;
+    stats.highWaterMark = _highWaterMark;
+    stats.bytesReserved = _bytesReserved;
+    stats.ceilingBytes = _ceilingBytes;
+    stats.resetCount = _resetCount;
+    return stats;
+}
+
+void FrameArena::_AddChunk(size_t minBytes)
+{
+    size_t available = _ceilingBytes - std::min(_ceilingBytes, _bytesReserved);
+    if (minBytes > available)
+    {
+        throw std::runtime_error("FrameArena: Frame memory ceiling of " + std::to_string(_ceilingBytes) +
+            " bytes exceeded (" + std::to_string(_bytesReserved) + " reserved, " + std::to_string(minBytes) + " requested).");
+    }
+
+    Chunk chunk;
+    chunk.size = std::min(std::max(minBytes, _chunkBytes), available);
+    chunk.data.reset(new unsigned char[chunk.size]);
+    _bytesReserved += chunk.size;
+    _chunks.push_back(std::move(chunk));
+    _currentChunk = _chunks.size() - 1;
+}
+
+void FrameArena::_ReleaseChunks()
+{
+    _chunks.clear();
+    _currentChunk = 0;
+    _bytesReserved = 0;
+    _bytesUsed = 0;
+    ++_generation;
+}
\ No newline at end of file
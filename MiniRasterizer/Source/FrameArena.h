@@ -0,0 +1,175 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+struct FrameArenaStats
+{
+    size_t bytesUsed = 0;      // Allocated since the last Reset
+    size_t highWaterMark = 0;  // Largest bytesUsed seen since construction or ResetHighWaterMark
+    size_t bytesReserved = 0;  // Memory actually held by the arena
+    size_t ceilingBytes = 0;
+    uint64_t resetCount = 0;
+};
+
+// Bump allocator for data that lives for one frame. Allocation is a pointer increment, nothing is freed
+// individually; Reset() rewinds everything at once and keeps the memory for the next frame.
+// The arena never holds more than its ceiling: an allocation that would need more throws std::runtime_error.
+class FrameArena
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 1024 * 1024;
+    static constexpr size_t NO_CEILING = std::numeric_limits<size_t>::max();
+
+    explicit FrameArena(size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    // Lowering the ceiling below what is reserved releases the memory; throws if called with live allocations
+    void SetCeiling(size_t ceilingBytes);
+    size_t GetCeiling() const { return _ceilingBytes; }
+
+    void* Allocate(size_t bytes, size_t alignment);
+
+    // Grows or shrinks the most recent allocation in place; returns false if ptr is not the most recent one
+    // or there is no room after it
+    bool TryResize(void* ptr, size_t oldBytes, size_t newBytes);
+
+    // Invalidates every allocation. Memory spread over several chunks is merged into one for the next frame.
+    void Reset();
+
+    // Bumped by Reset, lets ArenaVector notice that its storage is gone
+    uint64_t GetGeneration() const { return _generation; }
+
+    FrameArenaStats GetStats() const;
+    void ResetHighWaterMark() { _highWaterMark = _bytesUsed; }
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+        size_t used = 0;
+    };
+
+    void _AddChunk(size_t minBytes);
+    void _ReleaseChunks();
+
+    std::vector<Chunk> _chunks;
+    size_t _currentChunk = 0;
+    size_t _chunkBytes;
+    size_t _ceilingBytes = NO_CEILING;
+    size_t _bytesReserved = 0;
+    size_t _bytesUsed = 0;
+    size_t _highWaterMark = 0;
+    uint64_t _generation = 0;
+    uint64_t _resetCount = 0;
+};
+
+// Minimal vector whose storage comes from a FrameArena. Growth extends in place when the vector is the
+// arena's most recent allocation, which is the common case for a stage filling its output.
+// Only for trivially copyable types. After the arena is Reset the contents are gone; clear() makes the
+// vector usable again.
+template <typename T>
+class ArenaVector
+{
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+        "ArenaVector only holds trivially copyable types");
+
+public:
+    explicit ArenaVector(FrameArena& arena)
+        : _arena(&arena)
+    {
+    }
+
+    ArenaVector(const ArenaVector&) = delete;
+    ArenaVector& operator=(const ArenaVector&) = delete;
+
+    void clear()
+    {
+        _size = 0;
+        if (_generation != _arena->GetGeneration())
+        {
+            _data = nullptr;
+            _capacity = 0;
+        }
+    }
+
+    void reserve(size_t count)
+    {
+        if (count > _capacity)
+        {
+            _Grow(count);
+        }
+    }
+
+    // New elements are left uninitialized for the caller to write by index, e.g. from parallel jobs
+    void resize(size_t count)
+    {
+        reserve(count);
+        _size = count;
+    }
+
+    void push_back(const T& value)
+    {
+        if (_size == _capacity)
+        {
+            _Grow(_capacity < 64 ? 64 : _capacity * 2);
+        }
+        new (_data + _size) T(value);
+        ++_size;
+    }
+
+    // Hands unused capacity back to the arena when possible
+    void shrink_to_fit()
+    {
+        if (_capacity > _size && _arena->TryResize(_data, _capacity * sizeof(T), _size * sizeof(T)))
+        {
+            _capacity = _size;
+        }
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+    T& operator[](size_t i) { return _data[i]; }
+    const T& operator[](size_t i) const { return _data[i]; }
+    T* begin() { return _data; }
+    T* end() { return _data + _size; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+private:
+    void _Grow(size_t newCapacity)
+    {
+        if (_data && _arena->TryResize(_data, _capacity * sizeof(T), newCapacity * sizeof(T)))
+        {
+            _capacity = newCapacity;
+            return;
+        }
+
+        T* newData = static_cast<T*>(_arena->Allocate(newCapacity * sizeof(T), alignof(T)));
+        if (_size > 0)
+        {
+            std::memcpy(static_cast<void*>(newData), _data, _size * sizeof(T));
+        }
+        _data = newData;
+        _capacity = newCapacity;
+        _generation = _arena->GetGeneration();
+    }
+
+    FrameArena* _arena;
+    T* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    uint64_t _generation = 0;
+};
\ No newline at end of file
@@ -0,0 +1,362 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "FrameBuffer.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "JobSystem.h"
+
+namespace
+{
+    // Words per clear and resolve job
+    constexpr size_t PACKED_CLEAR_GRAIN_SIZE = 1 << 16;
+    constexpr size_t PACKED_RESOLVE_GRAIN_ROWS = 16;
+}
+
+FrameBuffer::FrameBuffer(int width, int height, BufferLayout layout)
+    : _width(width),
+    _height(height),
+    _tilesX((width + TILE_SIZE - 1) / TILE_SIZE),
+    _tilesY((height + TILE_SIZE - 1) / TILE_SIZE),
+    _layout(layout),
+    _clearDepth(std::numeric_limits<float>::infinity()),
+    _clearColor(0, 0, 0)
+{
+    _Allocate();
+}
+
+void FrameBuffer::SetLayout(BufferLayout layout)
+{
+    if (_layout == layout)
+    {
+        return;
+    }
+    _layout = layout;
+    _Allocate();
+}
+
+void FrameBuffer::SetSampleCount(int sampleCount)
+{
+    if (sampleCount != 1 && sampleCount != MAX_SAMPLE_COUNT)
+    {
+        throw std::runtime_error("FrameBuffer: Sample count must be 1 or " + std::to_string(MAX_SAMPLE_COUNT) + ".");
+    }
+    if (sampleCount == _sampleCount)
+    {
+        return;
+    }
+    _sampleCount = sampleCount;
+    _Allocate();
+}
+
+void FrameBuffer::SetPixelStorage(PixelStorage storage)
+{
+    if (storage == _storage)
+    {
+        return;
+    }
+    _storage = storage;
+    _Allocate();
+}
+
+void FrameBuffer::Resize(int width, int height)
+{
+    if (width == _width && height == _height)
+    {
+        return;
+    }
+    _width = width;
+    _height = height;
+    _tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    _tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    _Allocate();
+}
+
+void FrameBuffer::Clear(float depth, const Vec3& color)
+{
+    if (_storage == PixelStorage::PackedAtomic)
+    {
+        _clearDepth = depth;
+        _clearColor = color;
+        _ClearPacked();
+        _isResolveDirty = true;
+        return;
+    }
+
+    bool isSameClearColor = color.x == _clearColor.x && color.y == _clearColor.y && color.z == _clearColor.z;
+    if (!isSameClearColor)
+    {
+        // Resolved tiles that hold the old clear color are no longer valid
+        std::fill(_isResolvedTileClear.begin(), _isResolvedTileClear.end(), 0);
+    }
+
+    _clearDepth = depth;
+    _clearColor = color;
+    std::fill(_isTileClearPending.begin(), _isTileClearPending.end(), 1);
+    _isResolveDirty = true;
+}
+
+const std::vector<Vec3>& FrameBuffer::ResolveColor() const
+{
+    if (!_isResolveDirty)
+    {
+        return _resolvedColor;
+    }
+
+    if (_storage == PixelStorage::PackedAtomic)
+    {
+        JobSystem::ParallelFor(static_cast<size_t>(_height), PACKED_RESOLVE_GRAIN_ROWS, [this](size_t firstRow, size_t lastRow)
+        {
+            for (int y = static_cast<int>(firstRow); y < static_cast<int>(lastRow); ++y)
+            {
+                Vec3* outRow = &_resolvedColor[static_cast<size_t>(y) * _width];
+                for (int x = 0; x < _width; ++x)
+                {
+                    const std::atomic<uint64_t>* samples = &_packed[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                    Vec3 sum = _UnpackColor(static_cast<uint32_t>(samples[0].load(std::memory_order_relaxed)));
+                    for (int s = 1; s < _sampleCount; ++s)
+                    {
+                        sum = sum + _UnpackColor(static_cast<uint32_t>(samples[s].load(std::memory_order_relaxed)));
+                    }
+                    outRow[x] = _sampleCount == 1 ? sum : sum * (1.0f / _sampleCount);
+                }
+            }
+        });
+        _isResolveDirty = false;
+        return _resolvedColor;
+    }
+
+    for (int tileIndex = 0; tileIndex < _tilesX * _tilesY; ++tileIndex)
+    {
+        bool isPending = _isTileClearPending[tileIndex] != 0;
+        if (isPending && _isResolvedTileClear[tileIndex])
+        {
+            continue;
+        }
+
+        int x0, y0, x1, y1;
+        _GetTileRect(tileIndex, x0, y0, x1, y1);
+
+        for (int y = y0; y < y1; ++y)
+        {
+            Vec3* outRow = &_resolvedColor[y * _width];
+            for (int x = x0; x < x1; ++x)
+            {
+                if (isPending)
+                {
+                    outRow[x] = _clearColor;
+                }
+                else if (_sampleCount == 1)
+                {
+                    outRow[x] = _color[GetIndex(x, y)];
+                }
+                else
+                {
+                    // Box filter over the pixel's samples
+                    const Vec3* samples = &_color[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                    Vec3 sum = samples[0];
+                    for (int s = 1; s < _sampleCount; ++s)
+                    {
+                        sum = sum + samples[s];
+                    }
+                    outRow[x] = sum * (1.0f / _sampleCount);
+                }
+            }
+        }
+        _isResolvedTileClear[tileIndex] = isPending ? 1 : 0;
+    }
+
+    _isResolveDirty = false;
+    return _resolvedColor;
+}
+
+void FrameBuffer::ResolveDepth(float* out) const
+{
+    if (_storage == PixelStorage::PackedAtomic)
+    {
+        for (int y = 0; y < _height; ++y)
+        {
+            float* outRow = out + static_cast<size_t>(y) * _width;
+            for (int x = 0; x < _width; ++x)
+            {
+                // The depth bits order like the words, so the smallest word holds the nearest sample
+                const std::atomic<uint64_t>* samples = &_packed[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                uint64_t nearest = samples[0].load(std::memory_order_relaxed);
+                for (int s = 1; s < _sampleCount; ++s)
+                {
+                    nearest = std::min(nearest, samples[s].load(std::memory_order_relaxed));
+                }
+                outRow[x] = _UnpackDepth(static_cast<uint32_t>(nearest >> 32));
+            }
+        }
+        return;
+    }
+
+    for (int tileIndex = 0; tileIndex < _tilesX * _tilesY; ++tileIndex)
+    {
+        bool isPending = _isTileClearPending[tileIndex] != 0;
+        int x0, y0, x1, y1;
+        _GetTileRect(tileIndex, x0, y0, x1, y1);
+
+        for (int y = y0; y < y1; ++y)
+        {
+            float* outRow = out + static_cast<size_t>(y) * _width;
+            for (int x = x0; x < x1; ++x)
+            {
+                if (isPending)
+                {
+                    outRow[x] = _clearDepth;
+                    continue;
+                }
+                const float* samples = &_depth[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                float depth = samples[0];
+                for (int s = 1; s < _sampleCount; ++s)
+                {
+                    depth = std::min(depth, samples[s]);
+                }
+                outRow[x] = depth;
+            }
+        }
+    }
+}
+
+uint64_t FrameBuffer::CountCoveredPixels() const
+{
+    uint64_t coveredPixels = 0;
+    if (_storage == PixelStorage::PackedAtomic)
+    {
+        const uint32_t clearDepthBits = _PackDepth(_clearDepth);
+        for (int y = 0; y < _height; ++y)
+        {
+            for (int x = 0; x < _width; ++x)
+            {
+                const std::atomic<uint64_t>* samples = &_packed[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                for (int s = 0; s < _sampleCount; ++s)
+                {
+                    if (static_cast<uint32_t>(samples[s].load(std::memory_order_relaxed) >> 32) != clearDepthBits)
+                    {
+                        coveredPixels++;
+                        break;
+                    }
+                }
+            }
+        }
+        return coveredPixels;
+    }
+
+    for (int tileIndex = 0; tileIndex < _tilesX * _tilesY; ++tileIndex)
+    {
+        if (_isTileClearPending[tileIndex])
+        {
+            continue;
+        }
+
+        int x0, y0, x1, y1;
+        _GetTileRect(tileIndex, x0, y0, x1, y1);
+        for (int y = y0; y < y1; ++y)
+        {
+            for (int x = x0; x < x1; ++x)
+            {
+                const float* samples = &_depth[static_cast<size_t>(GetIndex(x, y)) * _sampleCount];
+                for (int s = 0; s < _sampleCount; ++s)
+                {
+                    if (samples[s] != _clearDepth)
+                    {
+                        coveredPixels++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return coveredPixels;
+}
+
+size_t FrameBuffer::_GetStorageSize() const
+{
+    // Tiled storage is padded up to whole tiles so edge tiles keep the same addressing
+    size_t pixelCount = (_layout == BufferLayout::Tiled)
+        ? static_cast<size_t>(_tilesX) * _tilesY * TILE_PIXEL_COUNT
+        : static_cast<size_t>(_width) * _height;
+    return pixelCount * _sampleCount;
+}
+
+void FrameBuffer::_Allocate()
+{
+    size_t storageSize = _GetStorageSize();
+    size_t tileCount = static_cast<size_t>(_tilesX) * _tilesY;
+    _resolvedColor.assign(static_cast<size_t>(_width) * _height, _clearColor);
+    _isResolveDirty = true;
+
+    if (_storage == PixelStorage::PackedAtomic)
+    {
+        std::vector<float>().swap(_depth);
+        std::vector<Vec3>().swap(_color);
+        _isTileClearPending.assign(tileCount, 0);
+        _isResolvedTileClear.assign(tileCount, 0);
+        if (storageSize > _packedCapacity)
+        {
+            _packed = std::make_unique<std::atomic<uint64_t>[]>(storageSize);
+            _packedCapacity = storageSize;
+        }
+        _ClearPacked();
+        return;
+    }
+
+    // Every tile starts out pending and gets filled on first touch
+    _packed.reset();
+    _packedCapacity = 0;
+    _depth.assign(storageSize, _clearDepth);
+    _color.assign(storageSize, _clearColor);
+    _isTileClearPending.assign(tileCount, 1);
+    _isResolvedTileClear.assign(tileCount, 1);
+}
+
+void FrameBuffer::_ClearPacked()
+{
+    const uint64_t clearWord = (static_cast<uint64_t>(_PackDepth(_clearDepth)) << 32) | _PackColor(_clearColor);
+    JobSystem::ParallelFor(_GetStorageSize(), PACKED_CLEAR_GRAIN_SIZE, [this, clearWord](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            _packed[i].store(clearWord, std::memory_order_relaxed);
+        }
+    });
+}
+
+void FrameBuffer::_MaterializeTile(int tileIndex)
+{
+    _isTileClearPending[tileIndex] = 0;
+
+    if (_layout == BufferLayout::Tiled)
+    {
+        // A tile is one contiguous run of 64 pixels
+        size_t start = static_cast<size_t>(tileIndex) * TILE_PIXEL_COUNT * _sampleCount;
+        std::fill_n(_depth.begin() + start, TILE_PIXEL_COUNT * _sampleCount, _clearDepth);
+        std::fill_n(_color.begin() + start, TILE_PIXEL_COUNT * _sampleCount, _clearColor);
+        return;
+    }
+
+    int x0, y0, x1, y1;
+    _GetTileRect(tileIndex, x0, y0, x1, y1);
+    for (int y = y0; y < y1; ++y)
+    {
+        size_t begin = (static_cast<size_t>(y) * _width + x0) * _sampleCount;
+        size_t end = (static_cast<size_t>(y) * _width + x1) * _sampleCount;
+        std::fill(_depth.begin() + begin, _depth.begin() + end, _clearDepth);
+        std::fill(_color.begin() + begin, _color.begin() + end, _clearColor);
+    }
+}
+
+void FrameBuffer::_GetTileRect(int tileIndex, int& x0, int& y0, int& x1, int& y1) const
+{
+    x0 = (tileIndex % _tilesX) * TILE_SIZE;
+    y0 = (tileIndex / _tilesX) * TILE_SIZE;
+    x1 = std::min(x0 + TILE_SIZE, _width);
+    y1 = std::min(y0 + TILE_SIZE, _height);
+}
\ No newline at end of file
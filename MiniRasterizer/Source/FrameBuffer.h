@@ -0,0 +1,267 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "Vec3.h"
+
+// Memory layout of the depth and color buffers
+enum class BufferLayout
+{
+    Linear, // Row-major, index = y * width + x
+    Tiled   // 8x8 pixel tiles stored one after another, Morton (Z-order) inside each tile
+};
+
+// How depth and color are stored and written
+enum class PixelStorage
+{
+    Separate,    // Float depth and float RGB color in two buffers, written by one thread
+    PackedAtomic // One 64-bit word per sample, depth above RGB9E5 color, written from many threads with a CAS loop
+};
+
+// Owns the depth and color buffers of the pipeline.
+// All pixel access goes through GetIndex(), so callers never need to know the layout.
+// With multisampling every pixel stores GetSampleCount() depth and color samples next to each other,
+// and ResolveColor() averages them.
+//
+// Clears are lazy and tile-granular: Clear() only flags every tile as pending, and a tile is filled with the
+// clear values the first time it is touched. Call TouchTile() before reading or writing a pixel.
+//
+// PackedAtomic storage trades color precision (9-bit mantissas sharing a 5-bit exponent, still HDR) for a depth
+// test that needs no lock and no binning: TestAndSetPacked() is an atomic min on the word, and the depth bits are
+// ordered like the floats, so the nearest sample wins whichever thread gets there first. Its clears are eager and
+// spread over the job system, since lazy tile clears cannot be raced; call InvalidateResolve() instead of
+// TouchTile() before a batch of writes.
+class FrameBuffer
+{
+public:
+    static constexpr int TILE_SIZE = 8;
+    static constexpr int TILE_PIXEL_COUNT = TILE_SIZE * TILE_SIZE;
+
+    FrameBuffer(int width, int height, BufferLayout layout = BufferLayout::Linear);
+    ~FrameBuffer() = default;
+
+    void SetLayout(BufferLayout layout);
+    BufferLayout GetLayout() const { return _layout; }
+
+    // 1 or MAX_SAMPLE_COUNT samples per pixel
+    static constexpr int MAX_SAMPLE_COUNT = 4;
+    void SetSampleCount(int sampleCount);
+    int GetSampleCount() const { return _sampleCount; }
+
+    // Reallocates and clears
+    void SetPixelStorage(PixelStorage storage);
+    PixelStorage GetPixelStorage() const { return _storage; }
+
+    // Changes the pixel dimensions and clears. Storage keeps the capacity of the largest size so far,
+    // so going back and forth between sizes does not reallocate.
+    void Resize(int width, int height);
+
+    void Clear(float depth, const Vec3& color);
+
+    // Returns a row-major buffer of width * height. Untouched tiles are filled with the clear color,
+    // and only tiles that changed since the last resolve are copied.
+    const std::vector<Vec3>& ResolveColor() const;
+
+    // Writes width * height row-major depths to out; a multisampled pixel keeps its nearest sample
+    void ResolveDepth(float* out) const;
+
+    // Pixels whose depth was written since the last clear
+    uint64_t CountCoveredPixels() const;
+
+    void TouchTile(int x, int y)
+    {
+        int tileIndex = (y >> 3) * _tilesX + (x >> 3);
+        if (_isTileClearPending[tileIndex])
+        {
+            _MaterializeTile(tileIndex);
+        }
+        _isResolveDirty = true;
+    }
+
+    int GetIndex(int x, int y) const
+    {
+        if (_layout == BufferLayout::Linear)
+        {
+            return y * _width + x;
+        }
+        int tileIndex = (y >> 3) * _tilesX + (x >> 3);
+        return (tileIndex << 6) | _MortonEncode(x & 7, y & 7);
+    }
+
+    // Single-sampled access
+    float GetDepth(int index) const { return _depth[index]; }
+    const Vec3& GetColor(int index) const { return _color[index]; }
+
+    void SetPixel(int index, float depth, const Vec3& color)
+    {
+        _depth[index] = depth;
+        _color[index] = color;
+    }
+
+    // Multisampled access, sample in [0, GetSampleCount())
+    float GetSampleDepth(int index, int sample) const { return _depth[index * _sampleCount + sample]; }
+
+    void SetSample(int index, int sample, float depth, const Vec3& color)
+    {
+        _depth[index * _sampleCount + sample] = depth;
+        _color[index * _sampleCount + sample] = color;
+    }
+
+    // Packed-atomic access, safe from any number of threads at once. Ties at equal depth go to the smaller color
+    // code, so the result does not depend on the order of the writes. Returns whether the sample was written.
+    bool TestAndSetPacked(int index, int sample, float depth, const Vec3& color)
+    {
+        std::atomic<uint64_t>& target = _packed[static_cast<size_t>(index) * _sampleCount + sample];
+        const uint32_t depthBits = _PackDepth(depth);
+        uint64_t current = target.load(std::memory_order_relaxed);
+        if (depthBits > (current >> 32))
+        {
+            // Behind, and no color to pack
+            return false;
+        }
+
+        const uint64_t word = (static_cast<uint64_t>(depthBits) << 32) | _PackColor(color);
+        while (word < current)
+        {
+            // On failure current is reloaded and the test repeated against the winner
+            if (target.compare_exchange_weak(current, word, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void InvalidateResolve() { _isResolveDirty = true; }
+
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+
+private:
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "PackedAtomic storage needs lock-free 64-bit atomics");
+
+    // RGB9E5 as in EXT_texture_shared_exponent
+    static constexpr int RGB9E5_MANTISSA_BITS = 9;
+    static constexpr int RGB9E5_EXPONENT_BIAS = 15;
+    static constexpr uint32_t RGB9E5_MANTISSA_MASK = (1u << RGB9E5_MANTISSA_BITS) - 1;
+    static constexpr float RGB9E5_MAX_VALUE = 65408.0f; // 511 / 512 * 2^16
+
+    static uint32_t _FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static float _BitsFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 2^exponent for exponent in the normal float range
+    static float _PowerOfTwo(int exponent)
+    {
+        return _BitsFloat(static_cast<uint32_t>(exponent + 127) << 23);
+    }
+
+    // Float bits reordered so that unsigned comparison matches float comparison, negative depths included:
+    // positive floats sort above negative ones once the sign bit is set, negative ones sort backwards so are flipped
+    static uint32_t _PackDepth(float depth)
+    {
+        uint32_t bits = _FloatBits(depth);
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    static float _UnpackDepth(uint32_t bits)
+    {
+        return _BitsFloat((bits & 0x80000000u) ? (bits & 0x7FFFFFFFu) : ~bits);
+    }
+
+    // Negative and NaN channels become 0, large ones saturate at RGB9E5_MAX_VALUE
+    static uint32_t _PackColor(const Vec3& color)
+    {
+        // Written as !(c > 0) so that NaN lands on 0 as well
+        auto clampChannel = [](float c) { return !(c > 0.0f) ? 0.0f : std::min(c, RGB9E5_MAX_VALUE); };
+        float r = clampChannel(color.x);
+        float g = clampChannel(color.y);
+        float b = clampChannel(color.z);
+        float maxChannel = std::max(r, std::max(g, b));
+        if (maxChannel == 0.0f)
+        {
+            return 0;
+        }
+
+        // The exponent that fits the largest channel into 9 bits, rounding may push it one further
+        int exponent = static_cast<int>(_FloatBits(maxChannel) >> 23) - 127; // floor(log2(maxChannel))
+        int sharedExponent = std::max(-RGB9E5_EXPONENT_BIAS - 1, exponent) + 1 + RGB9E5_EXPONENT_BIAS;
+        float scale = _PowerOfTwo(RGB9E5_MANTISSA_BITS + RGB9E5_EXPONENT_BIAS - sharedExponent);
+        if (static_cast<uint32_t>(maxChannel * scale + 0.5f) > RGB9E5_MANTISSA_MASK)
+        {
+            sharedExponent++;
+            scale *= 0.5f;
+        }
+
+        uint32_t red = static_cast<uint32_t>(r * scale + 0.5f);
+        uint32_t green = static_cast<uint32_t>(g * scale + 0.5f);
+        uint32_t blue = static_cast<uint32_t>(b * scale + 0.5f);
+        return red | (green << RGB9E5_MANTISSA_BITS) | (blue << (2 * RGB9E5_MANTISSA_BITS)) |
+            (static_cast<uint32_t>(sharedExponent) << (3 * RGB9E5_MANTISSA_BITS));
+    }
+
+    static Vec3 _UnpackColor(uint32_t bits)
+    {
+        int sharedExponent = static_cast<int>(bits >> (3 * RGB9E5_MANTISSA_BITS));
+        float scale = _PowerOfTwo(sharedExponent - RGB9E5_EXPONENT_BIAS - RGB9E5_MANTISSA_BITS);
+        return Vec3(
+            static_cast<float>(bits & RGB9E5_MANTISSA_MASK) * scale,
+            static_cast<float>((bits >> RGB9E5_MANTISSA_BITS) & RGB9E5_MANTISSA_MASK) * scale,
+            static_cast<float>((bits >> (2 * RGB9E5_MANTISSA_BITS)) & RGB9E5_MANTISSA_MASK) * scale);
+    }
+
+    void _ClearPacked();
+    size_t _GetStorageSize() const;
+    void _Allocate();
+    void _MaterializeTile(int tileIndex);
+    void _GetTileRect(int tileIndex, int& x0, int& y0, int& x1, int& y1) const;
+
+    // Interleaves the bits of a 3-bit x and y (0..7) into a 6-bit Z-order index
+    static int _MortonEncode(int x, int y)
+    {
+        static constexpr uint8_t spread[TILE_SIZE] = { 0, 1, 4, 5, 16, 17, 20, 21 };
+        return spread[x] | (spread[y] << 1);
+    }
+
+    int _width;
+    int _height;
+    int _tilesX;
+    int _tilesY;
+    BufferLayout _layout;
+    int _sampleCount = 1;
+    PixelStorage _storage = PixelStorage::Separate;
+
+    std::vector<float> _depth;
+    std::vector<Vec3> _color;
+    std::unique_ptr<std::atomic<uint64_t>[]> _packed; // PackedAtomic storage only
+    size_t _packedCapacity = 0; // Words in _packed, the largest storage size so far
+
+    // Lazy clear state
+    float _clearDepth;
+    Vec3 _clearColor;
+    std::vector<uint8_t> _isTileClearPending;
+
+    // Resolve cache, a tile is skipped when it is still pending and the resolved copy already holds the clear color
+    mutable std::vector<Vec3> _resolvedColor;
+    mutable std::vector<uint8_t> _isResolvedTileClear;
+    mutable bool _isResolveDirty = true;
+};
\ No newline at end of file
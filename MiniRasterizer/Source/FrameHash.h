@@ -0,0 +1,53 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "Vec3.h"
+
+// Accumulates the inputs of a frame (state versions, positions, pointers) into a 64-bit key.
+// Two frames with the same key are treated as identical by RenderPipeline::BeginFrame.
+class FrameHash
+{
+public:
+    void Add(uint64_t value)
+    {
+        // boost::hash_combine style mixing, widened to 64 bits
+        _value ^= _Mix(value) + 0x9E3779B97F4A7C15ull + (_value << 6) + (_value >> 2);
+    }
+
+    void Add(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Add(static_cast<uint64_t>(bits));
+    }
+
+    void Add(const Vec3& value)
+    {
+        Add(value.x);
+        Add(value.y);
+        Add(value.z);
+    }
+
+    void Add(const void* pointer)
+    {
+        Add(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)));
+    }
+
+    uint64_t GetValue() const { return _value; }
+
+private:
+    // SplitMix64 finalizer
+    static uint64_t _Mix(uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t _value = 0;
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <cmath>
+
+#include "Vec3.h"
+#include "Camera.h"
+#include "MeshData.h"
+
+enum class FrustumTest
+{
+    Outside,
+    Intersecting,
+    Inside
+};
+
+// The six clip planes of a camera in world space, matching ShaderUtils' view and projection transforms
+// (the camera only translates and looks down -z)
+class Frustum
+{
+public:
+    static constexpr int PLANE_COUNT = 6;
+    static constexpr unsigned int ALL_PLANES = (1u << PLANE_COUNT) - 1;
+
+    // A point p is inside the plane when normal.dot(p) + distance >= 0
+    struct Plane
+    {
+        Vec3 normal;
+        float distance;
+    };
+
+    explicit Frustum(const Camera& camera)
+        : Frustum(camera, -1.0f, 1.0f, -1.0f, 1.0f)
+    {
+    }
+
+    // The part of the camera frustum that projects into [ndcMinX, ndcMaxX] x [ndcMinY, ndcMaxY], such as one bucket
+    Frustum(const Camera& camera, float ndcMinX, float ndcMaxX, float ndcMinY, float ndcMaxY)
+    {
+        float focal = 1.0f / std::tan(camera.fov / 2.0f);
+        float focalX = focal / camera.aspectRatio;
+
+        // In view space, with w = -z: x_clip >= ndcMinX * w, x_clip <= ndcMaxX * w, the same for y,
+        // -z >= near, -z <= far
+        _SetPlane(0, Vec3(focalX, 0.0f, ndcMinX), 0.0f, camera.position);
+        _SetPlane(1, Vec3(-focalX, 0.0f, -ndcMaxX), 0.0f, camera.position);
+        _SetPlane(2, Vec3(0.0f, focal, ndcMinY), 0.0f, camera.position);
+        _SetPlane(3, Vec3(0.0f, -focal, -ndcMaxY), 0.0f, camera.position);
+        _SetPlane(4, Vec3(0.0f, 0.0f, -1.0f), -camera.nearPlane, camera.position);
+        _SetPlane(5, Vec3(0.0f, 0.0f, 1.0f), camera.farPlane, camera.position);
+    }
+
+    const Plane& GetPlane(int index) const { return _planes[index]; }
+
+    // Tests the box against the planes whose bit is set in planeMask. Planes the box lies fully inside are
+    // cleared from planeMask, so a hierarchy can skip them for everything below this box.
+    FrustumTest Test(const MeshBounds& bounds, unsigned int& planeMask) const
+    {
+        for (int i = 0; i < PLANE_COUNT; ++i)
+        {
+            if (!(planeMask & (1u << i)))
+            {
+                continue;
+            }
+            const Plane& plane = _planes[i];
+
+            // The corners furthest along and against the normal
+            Vec3 farCorner(
+                plane.normal.x >= 0.0f ? bounds.max.x : bounds.min.x,
+                plane.normal.y >= 0.0f ? bounds.max.y : bounds.min.y,
+                plane.normal.z >= 0.0f ? bounds.max.z : bounds.min.z);
+            Vec3 nearCorner(
+                plane.normal.x >= 0.0f ? bounds.min.x : bounds.max.x,
+                plane.normal.y >= 0.0f ? bounds.min.y : bounds.max.y,
+                plane.normal.z >= 0.0f ? bounds.min.z : bounds.max.z);
+            if (plane.normal.dot(farCorner) + plane.distance < 0.0f)
+            {
+                return FrustumTest::Outside;
+            }
+            if (plane.normal.dot(nearCorner) + plane.distance >= 0.0f)
+            {
+                planeMask &= ~(1u << i);
+            }
+        }
+        return planeMask == 0 ? FrustumTest::Inside : FrustumTest::Intersecting;
+    }
+
+private:
+    // viewNormal and viewDistance describe the plane in view space, which is world space shifted by the camera
+    void _SetPlane(int index, const Vec3& viewNormal, float viewDistance, const Vec3& cameraPosition)
+    {
+        _planes[index].normal = viewNormal;
+        _planes[index].distance = viewDistance - viewNormal.dot(cameraPosition);
+    }
+
+    Plane _planes[PLANE_COUNT];
+};
\ No newline at end of file
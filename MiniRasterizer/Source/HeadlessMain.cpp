@@ -0,0 +1,644 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+// Offscreen renderer for machines without a display: no SFML, no font, just the pipeline and an image file.
+
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <functional>
+#include <sstream>
+
+#include "RenderPipeline.h"
+#include "JobSystem.h"
+#include "SceneDescription.h"
+#include "Scene.h"
+#include "ImageWriter.h"
+#include "PostProcess.h"
+#include "RenderGraph.h"
+#include "BucketRenderer.h"
+#include "Profiler.h"
+#include "FrameHash.h"
+
+namespace
+{
+    // Distance between the cameras of neighbouring views
+    constexpr float VIEW_SPACING = 1.0f;
+
+    constexpr float BLOOM_THRESHOLD = 0.8f;
+    constexpr float BLOOM_STRENGTH = 0.6f;
+    constexpr float OUTLINE_DEPTH_THRESHOLD = 0.05f;
+
+    struct HeadlessOptions
+    {
+        SceneDescription scene;
+        std::string outputPath = "output.ppm";
+        std::string tracePath;
+        int frameCount = 1;
+        BufferLayout layout = BufferLayout::Linear;
+        PixelStorage pixelStorage = PixelStorage::Separate;
+        size_t vertexCacheBytes = 0;
+        size_t frameMemoryCeilingBytes = FrameArena::NO_CEILING;
+        float renderScale = 1.0f;
+        int sampleCount = 1;
+        int viewCount = 1;
+        int atlasCellSize = 0; // 0 renders the scene, otherwise a thumbnail atlas of its materials
+        int bucketSize = 0;    // 0 renders the whole frame at once, otherwise bucket by bucket into the output file
+        int threadCount = 0;   // 0 uses every hardware thread
+        PostProcessSettings postProcess;
+        bool isBloomEnabled = false;
+        bool isOutlineEnabled = false;
+        double targetFrameMs = 0.0;
+        bool isPrintingStatistics = false;
+    };
+
+    void PrintStatistics(const PipelineStatistics& stats)
+    {
+        std::printf("statistics (last frame):\n");
+        std::printf("  draw calls            %llu (%llu vertex cache hits)\n",
+            (unsigned long long)stats.drawCalls, (unsigned long long)stats.vertexCacheHits);
+        std::printf("  vertices shaded       %llu\n", (unsigned long long)stats.verticesShaded);
+        if (stats.viewsCulled > 0)
+        {
+            std::printf("  views culled          %llu\n", (unsigned long long)stats.viewsCulled);
+        }
+        std::printf("  triangles submitted   %llu\n", (unsigned long long)stats.trianglesSubmitted);
+        std::printf("  triangles culled      %llu (invalid index %llu, near plane %llu, offscreen %llu, degenerate %llu)\n",
+            (unsigned long long)stats.GetTrianglesCulled(),
+            (unsigned long long)stats.trianglesCulledInvalidIndex,
+            (unsigned long long)stats.trianglesCulledNearPlane,
+            (unsigned long long)stats.trianglesCulledOffscreen,
+            (unsigned long long)stats.trianglesCulledDegenerate);
+        std::printf("  triangles rasterized  %llu\n", (unsigned long long)stats.trianglesRasterized);
+        std::printf("  bbox pixels tested    %llu\n", (unsigned long long)stats.boundingBoxPixelsTested);
+        std::printf("  fragments generated   %llu\n", (unsigned long long)stats.fragmentsGenerated);
+        std::printf("  fragments shaded      %llu\n", (unsigned long long)stats.fragmentsShaded);
+        std::printf("  depth test pass/fail  %llu / %llu\n",
+            (unsigned long long)stats.depthTestPasses, (unsigned long long)stats.depthTestFailures);
+        std::printf("  pixels covered        %llu (overdraw %.2fx)\n",
+            (unsigned long long)stats.pixelsCovered, stats.GetOverdrawRatio());
+        std::printf("  stage ms              vertex %.3f, triangle %.3f, raster %.3f, fragment %.3f, framebuffer %.3f, total %.3f\n",
+            stats.vertexMs, stats.triangleMs, stats.rasterMs, stats.fragmentMs, stats.framebufferMs, stats.totalMs);
+    }
+
+    // 2 views are a side-by-side pair, 4 a 2x2 grid; the cameras are shifted apart to match their place in the grid
+    std::vector<RenderView> CreateViews(const SceneDescription& description, int viewCount)
+    {
+        const int columns = viewCount > 1 ? 2 : 1;
+        const int rows = viewCount > 2 ? 2 : 1;
+        std::vector<RenderView> views;
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                RenderView view;
+                view.x = description.width * column / columns;
+                view.y = description.height * row / rows;
+                view.width = description.width * (column + 1) / columns - view.x;
+                view.height = description.height * (row + 1) / rows - view.y;
+
+                Vec3 offset((column - (columns - 1) * 0.5f) * VIEW_SPACING, ((rows - 1) * 0.5f - row) * VIEW_SPACING, 0.0f);
+                view.camera = Camera(description.cameraPosition + offset, Vec3(0.0f, 0.0f, -1.0f), description.cameraFov,
+                    static_cast<float>(view.width) / view.height);
+                views.push_back(view);
+            }
+        }
+        return views;
+    }
+
+    bool HasPostEffects(const HeadlessOptions& options)
+    {
+        return options.isBloomEnabled || options.isOutlineEnabled;
+    }
+
+    // The frame as a render graph. Every effect is declared, but the composite only reads the enabled ones, so
+    // Compile() culls the rest; the bloom chain and the outline only share the scene pass and run side by side.
+    void BuildFrameGraph(
+        RenderGraph& graph,
+        const HeadlessOptions& options,
+        RenderPipeline& pipeline,
+        std::function<void()> renderScene,
+        std::vector<Vec3>& output)
+    {
+        const int width = options.scene.width;
+        const int height = options.scene.height;
+        const int bloomWidth = (width + 1) / 2;
+        const int bloomHeight = (height + 1) / 2;
+
+        RenderTargetHandle sceneColor = graph.CreateTarget("SceneColor", { width, height, RenderTargetFormat::Color });
+        RenderTargetHandle sceneDepth = graph.CreateTarget("SceneDepth", { width, height, RenderTargetFormat::Depth });
+        RenderTargetHandle bright = graph.CreateTarget("BloomBright", { bloomWidth, bloomHeight, RenderTargetFormat::Color });
+        RenderTargetHandle blurX = graph.CreateTarget("BloomBlurX", { bloomWidth, bloomHeight, RenderTargetFormat::Color });
+        RenderTargetHandle bloom = graph.CreateTarget("Bloom", { bloomWidth, bloomHeight, RenderTargetFormat::Color });
+        RenderTargetHandle edges = graph.CreateTarget("OutlineEdges", { width, height, RenderTargetFormat::Depth });
+        RenderTargetHandle finalColor = graph.ImportColor("Output", output, width, height);
+
+        graph.AddPass("ScenePass", {}, { sceneColor, sceneDepth },
+            [&pipeline, renderScene, sceneColor, sceneDepth](const RenderPassContext& context)
+            {
+                renderScene();
+                const std::vector<Vec3>& color = pipeline.GetFinalColorBuffer();
+                std::copy(color.begin(), color.end(), context.GetColor(sceneColor));
+                pipeline.CopyFinalDepthBuffer(context.GetDepth(sceneDepth));
+            });
+        graph.AddPass("BloomExtract", { sceneColor }, { bright },
+            [=](const RenderPassContext& context)
+            {
+                PostProcess::ExtractBright(context.GetColor(sceneColor), width, height, BLOOM_THRESHOLD, context.GetColor(bright));
+            });
+        graph.AddPass("BloomBlurX", { bright }, { blurX },
+            [=](const RenderPassContext& context)
+            {
+                PostProcess::BlurHorizontal(context.GetColor(bright), bloomWidth, bloomHeight, context.GetColor(blurX));
+            });
+        graph.AddPass("BloomBlurY", { blurX }, { bloom },
+            [=](const RenderPassContext& context)
+            {
+                PostProcess::BlurVertical(context.GetColor(blurX), bloomWidth, bloomHeight, context.GetColor(bloom));
+            });
+        graph.AddPass("Outline", { sceneDepth }, { edges },
+            [=](const RenderPassContext& context)
+            {
+                PostProcess::DetectDepthEdges(context.GetDepth(sceneDepth), width, height, OUTLINE_DEPTH_THRESHOLD,
+                    context.GetDepth(edges));
+            });
+
+        std::vector<RenderTargetHandle> compositeReads = { sceneColor };
+        if (options.isBloomEnabled)
+        {
+            compositeReads.push_back(bloom);
+        }
+        if (options.isOutlineEnabled)
+        {
+            compositeReads.push_back(edges);
+        }
+        const bool isBloomEnabled = options.isBloomEnabled;
+        const bool isOutlineEnabled = options.isOutlineEnabled;
+        graph.AddPass("Composite", compositeReads, { finalColor },
+            [=](const RenderPassContext& context)
+            {
+                PostProcess::Composite(context.GetColor(sceneColor), width, height,
+                    isBloomEnabled ? context.GetColor(bloom) : nullptr, bloomWidth, bloomHeight, BLOOM_STRENGTH,
+                    isOutlineEnabled ? context.GetDepth(edges) : nullptr,
+                    context.GetColor(finalColor));
+            });
+        graph.Compile();
+    }
+
+    void PrintRenderGraph(const RenderGraph& graph)
+    {
+        const RenderGraphStats& stats = graph.GetStats();
+        std::printf("render graph: %zu passes (%zu culled) in %zu levels, transient targets %.2f MB aliased into %.2f MB\n",
+            stats.passCount, stats.passesCulled, stats.levelCount,
+            stats.transientBytes / (1024.0 * 1024.0), stats.allocatedBytes / (1024.0 * 1024.0));
+        std::vector<std::vector<std::string>> schedule = graph.GetSchedule();
+        for (size_t level = 0; level < schedule.size(); ++level)
+        {
+            std::string names;
+            for (const std::string& name : schedule[level])
+            {
+                names += (names.empty() ? "" : ", ") + name;
+            }
+            std::printf("  level %zu: %s\n", level, names.c_str());
+        }
+    }
+
+    void PrintUsage()
+    {
+        std::cout <<
+            "Usage: MiniRasterizerHeadless [options]\n"
+            "  --scene <file>           Load a scene file (see SceneDescription.h for the format)\n"
+            "  --set \"<directive>\"      Add one scene directive, e.g. --set \"sphere 3 64 0 0 0 toon RimWidth=0.3\"\n"
+            "  --width <px>             Output width (default 1080)\n"
+            "  --height <px>            Output height (default 720)\n"
+            "  --output <path>          Output image, .ppm or .png (default output.ppm)\n"
+            "  --frames <N>             Render N frames back to back and report timings (default 1)\n"
+            "  --layout <linear|tiled>  Depth and color buffer layout (default linear)\n"
+            "  --pixel-storage <s>      separate (float depth and color) or atomic (packed 64-bit words, depth tested\n"
+            "                           from all threads at once; default separate)\n"
+            "  --vertex-cache-mb <N>    Enable the cross-frame vertex cache with an N MB budget\n"
+            "  --frame-memory-mb <N>    Cap the per-frame stage memory at N MB; a frame that needs more fails\n"
+            "  --render-scale <s>       Rasterize at s times the output size and upscale (0 < s <= 1, default 1)\n"
+            "  --target-ms <ms>         Adjust the render scale every frame to hold this frame time\n"
+            "  --msaa <1|4>             Samples per pixel for anti-aliased edges (default 1)\n"
+            "  --views <1|2|4>          Draw side-by-side views from shifted cameras in one multi-view pass (default 1)\n"
+            "  --threads <N>            Threads for the parallel stages, including the main thread (default: all cores)\n"
+            "  --tonemap <op>           clamp, filmic or aces (default clamp)\n"
+            "  --exposure <e>           Scale the color before tonemapping (default 1)\n"
+            "  --srgb                   Encode the output as sRGB instead of writing linear values\n"
+            "  --fxaa                   Smooth edges with FXAA after tonemapping\n"
+            "  --post <effects>         Comma-separated post effects run through the render graph: bloom, outline\n"
+            "  --buckets <px>           Render px-sized buckets one at a time, streaming each into the output file, so\n"
+            "                           memory stays flat at any resolution; uses a 64 MB vertex cache unless\n"
+            "                           --vertex-cache-mb is given\n"
+            "  --atlas <px>             Instead of the scene, write an atlas of px-sized thumbnails of every object's\n"
+            "                           material on the first object's mesh, rasterized once and shaded per material\n"
+            "  --stats                  Print pipeline statistics for the last frame\n"
+            "  --trace <path>           Record a Chrome trace (chrome://tracing, Perfetto) of all frames\n"
+            "  --help                   Show this message\n"
+            "Without any sphere directive the MaterialPreviewer sphere is rendered.\n";
+    }
+
+    // Thumbnails share the first object's mesh, placed at the origin in front of the scene camera
+    void WriteMaterialAtlas(const HeadlessOptions& options, const LoadedScene& scene)
+    {
+        const SceneDescription& description = options.scene;
+        const int cellSize = options.atlasCellSize;
+        std::vector<const Material*> materials;
+        for (const auto& obj : scene.objects)
+        {
+            materials.push_back(obj->GetMaterial().get());
+        }
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(materials.size()))));
+        const int rows = static_cast<int>((materials.size() + columns - 1) / columns);
+
+        RenderPipeline pipeline(cellSize, cellSize);
+        pipeline.SetCamera(Camera(description.cameraPosition, Vec3(0.0f, 0.0f, -1.0f), description.cameraFov, 1.0f));
+        pipeline.SetLight(description.light);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Vec3> atlas = pipeline.RenderMaterialAtlas(
+            *scene.objects.front()->GetMesh(), Vec3(0.0f, 0.0f, 0.0f), materials, cellSize, cellSize, columns);
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("atlas: %zu material(s) at %dx%d in %.3f ms, %.1f thumbnails/s\n",
+            materials.size(), cellSize, cellSize, elapsedMs, materials.size() / (elapsedMs / 1000.0));
+        if (options.isPrintingStatistics)
+        {
+            PrintStatistics(pipeline.GetDrawStatistics());
+        }
+
+        std::vector<uint8_t> pixels;
+        pipeline.SetPostProcess(options.postProcess);
+        pipeline.ApplyPostProcess(atlas, columns * cellSize, rows * cellSize, pixels);
+        ImageWriter::WriteImage(options.outputPath, columns * cellSize, rows * cellSize, pixels);
+        std::printf("wrote %s\n", options.outputPath.c_str());
+    }
+
+    // The scene goes to the output file a bucket at a time; no full-size buffer is ever allocated
+    void RenderBuckets(const HeadlessOptions& options, const LoadedScene& scene)
+    {
+        const SceneDescription& description = options.scene;
+        BucketRenderer renderer(description.width, description.height, options.bucketSize);
+        RenderPipeline& pipeline = renderer.GetPipeline();
+        pipeline.SetCamera(description.CreateCamera());
+        pipeline.SetLight(description.light);
+        pipeline.SetBufferLayout(options.layout);
+        pipeline.SetPixelStorage(options.pixelStorage);
+        pipeline.SetSampleCount(options.sampleCount);
+        pipeline.SetFrameMemoryCeiling(options.frameMemoryCeilingBytes);
+        pipeline.SetPostProcess(options.postProcess);
+        if (options.vertexCacheBytes > 0)
+        {
+            pipeline.SetVertexCacheBudget(options.vertexCacheBytes);
+        }
+
+        Scene sceneTree;
+        for (const auto& obj : scene.objects)
+        {
+            sceneTree.Add(obj);
+        }
+        if (!options.tracePath.empty())
+        {
+            Profiler::SetThreadName("Main");
+            Profiler::SetEnabled(true);
+        }
+
+        renderer.Render(sceneTree, options.outputPath);
+        const BucketRenderStats& stats = renderer.GetStats();
+        std::printf("%d bucket(s) of %dx%d (%d empty) at %dx%d, %zu object(s), %llu object draws: %.3f ms\n",
+            stats.bucketCount, options.bucketSize, options.bucketSize, stats.bucketsEmpty,
+            description.width, description.height, scene.objects.size(), (unsigned long long)stats.objectDraws,
+            stats.totalMs);
+
+        if (options.isPrintingStatistics)
+        {
+            PrintStatistics(stats.pipeline);
+            FrameArenaStats arena = pipeline.GetFrameArenaStats();
+            VertexCacheStats vertexCache = pipeline.GetVertexCacheStats();
+            std::printf("frame memory: %.2f MB high-water mark, %.2f MB reserved; vertex cache %.2f MB\n",
+                arena.highWaterMark / (1024.0 * 1024.0), arena.bytesReserved / (1024.0 * 1024.0),
+                vertexCache.bytesUsed / (1024.0 * 1024.0));
+        }
+        std::printf("wrote %s\n", options.outputPath.c_str());
+
+        if (!options.tracePath.empty())
+        {
+            Profiler::WriteChromeTrace(options.tracePath);
+            std::printf("wrote %s\n", options.tracePath.c_str());
+        }
+    }
+
+    bool ParseArguments(int argc, char** argv, HeadlessOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                PrintUsage();
+                return false;
+            }
+            if (arg == "--stats")
+            {
+                options.isPrintingStatistics = true;
+                continue;
+            }
+            if (arg == "--srgb" || arg == "--fxaa")
+            {
+                (arg == "--srgb" ? options.postProcess.isSrgbEncoded : options.postProcess.isFxaaEnabled) = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value for argument '" + arg + "'.");
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--scene") { options.scene.LoadFile(value); }
+            else if (arg == "--set") { options.scene.ParseDirective(value); }
+            else if (arg == "--width") { options.scene.width = std::stoi(value); }
+            else if (arg == "--height") { options.scene.height = std::stoi(value); }
+            else if (arg == "--output") { options.outputPath = value; }
+            else if (arg == "--trace") { options.tracePath = value; }
+            else if (arg == "--frames") { options.frameCount = std::max(1, std::stoi(value)); }
+            else if (arg == "--vertex-cache-mb") { options.vertexCacheBytes = std::stoul(value) * 1024 * 1024; }
+            else if (arg == "--render-scale") { options.renderScale = std::stof(value); }
+            else if (arg == "--target-ms") { options.targetFrameMs = std::stod(value); }
+            else if (arg == "--msaa") { options.sampleCount = std::stoi(value); }
+            else if (arg == "--views") { options.viewCount = std::stoi(value); }
+            else if (arg == "--atlas") { options.atlasCellSize = std::stoi(value); }
+            else if (arg == "--buckets") { options.bucketSize = std::stoi(value); }
+            else if (arg == "--threads") { options.threadCount = std::stoi(value); }
+            else if (arg == "--exposure") { options.postProcess.exposure = std::stof(value); }
+            else if (arg == "--tonemap")
+            {
+                if (value == "clamp") { options.postProcess.tonemapper = Tonemapper::Clamp; }
+                else if (value == "filmic") { options.postProcess.tonemapper = Tonemapper::Filmic; }
+                else if (value == "aces") { options.postProcess.tonemapper = Tonemapper::ACES; }
+                else { throw std::runtime_error("Unknown tonemapper '" + value + "', expected clamp, filmic or aces."); }
+            }
+            else if (arg == "--post")
+            {
+                std::stringstream effects(value);
+                std::string effect;
+                while (std::getline(effects, effect, ','))
+                {
+                    if (effect == "bloom") { options.isBloomEnabled = true; }
+                    else if (effect == "outline") { options.isOutlineEnabled = true; }
+                    else { throw std::runtime_error("Unknown post effect '" + effect + "', expected bloom or outline."); }
+                }
+            }
+            else if (arg == "--frame-memory-mb") { options.frameMemoryCeilingBytes = std::stoul(value) * 1024 * 1024; }
+            else if (arg == "--pixel-storage")
+            {
+                if (value == "separate") { options.pixelStorage = PixelStorage::Separate; }
+                else if (value == "atomic") { options.pixelStorage = PixelStorage::PackedAtomic; }
+                else { throw std::runtime_error("Unknown pixel storage '" + value + "', expected separate or atomic."); }
+            }
+            else if (arg == "--layout")
+            {
+                if (value == "linear") { options.layout = BufferLayout::Linear; }
+                else if (value == "tiled") { options.layout = BufferLayout::Tiled; }
+                else { throw std::runtime_error("Unknown layout '" + value + "', expected linear or tiled."); }
+            }
+            else
+            {
+                throw std::runtime_error("Unknown argument '" + arg + "', see --help.");
+            }
+        }
+
+        if (options.scene.width <= 0 || options.scene.height <= 0)
+        {
+            throw std::runtime_error("Resolution must be positive.");
+        }
+        if (options.renderScale <= 0.0f || options.renderScale > 1.0f)
+        {
+            throw std::runtime_error("Render scale must be in (0, 1].");
+        }
+        if (options.viewCount != 1 && options.viewCount != 2 && options.viewCount != 4)
+        {
+            throw std::runtime_error("View count must be 1, 2 or 4.");
+        }
+        if (options.atlasCellSize < 0)
+        {
+            throw std::runtime_error("Atlas cell size must be positive.");
+        }
+        if (options.threadCount < 0)
+        {
+            throw std::runtime_error("Thread count must be positive.");
+        }
+        if (options.bucketSize < 0)
+        {
+            throw std::runtime_error("Bucket size must be positive.");
+        }
+        if (options.bucketSize > 0 && (options.frameCount > 1 || options.viewCount > 1 || options.renderScale != 1.0f ||
+            options.targetFrameMs > 0.0 || HasPostEffects(options) || options.postProcess.isFxaaEnabled))
+        {
+            throw std::runtime_error("--buckets renders one frame of one view, without --render-scale, --target-ms, "
+                "--post or --fxaa.");
+        }
+        if (options.scene.spheres.empty())
+        {
+            options.scene.AddDefaultSphere();
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        HeadlessOptions options;
+        if (!ParseArguments(argc, argv, options))
+        {
+            return 0;
+        }
+
+        JobSystem::SetThreadCount(options.threadCount);
+        const SceneDescription& description = options.scene;
+        LoadedScene scene = BuildScene(description);
+
+        if (options.atlasCellSize > 0)
+        {
+            WriteMaterialAtlas(options, scene);
+            return 0;
+        }
+        if (options.bucketSize > 0)
+        {
+            RenderBuckets(options, scene);
+            return 0;
+        }
+
+        RenderPipeline pipeline(description.width, description.height);
+        pipeline.SetCamera(description.CreateCamera());
+        pipeline.SetLight(description.light);
+        pipeline.SetBufferLayout(options.layout);
+        pipeline.SetPixelStorage(options.pixelStorage);
+        pipeline.SetSampleCount(options.sampleCount);
+        pipeline.SetVertexCacheBudget(options.vertexCacheBytes);
+        pipeline.SetFrameMemoryCeiling(options.frameMemoryCeilingBytes);
+        pipeline.SetRenderScale(options.renderScale);
+        pipeline.SetTargetFrameTime(options.targetFrameMs);
+        pipeline.SetPostProcess(options.postProcess);
+
+        if (!options.tracePath.empty())
+        {
+            Profiler::SetThreadName("Main");
+            Profiler::SetEnabled(true);
+        }
+
+        const std::vector<RenderView> views = CreateViews(description, options.viewCount);
+
+        // Objects outside the camera are culled through the scene BVH; a multi-view draw culls per view itself
+        Scene sceneTree;
+        for (const auto& obj : scene.objects)
+        {
+            sceneTree.Add(obj);
+        }
+        std::vector<SceneObjectId> drawnObjects;
+        uint64_t frameIndex = 0;
+        auto renderScene = [&]()
+        {
+            if (views.size() > 1)
+            {
+                sceneTree.GetObjects(drawnObjects);
+            }
+            else
+            {
+                sceneTree.QueryFrustum(description.CreateCamera(), drawnObjects);
+            }
+
+            // Describe the draw list like the previewer does. A --frames benchmark also keys on the frame index
+            // so every frame is rendered and timed rather than reused.
+            FrameHash sceneKey;
+            if (options.frameCount > 1)
+            {
+                sceneKey.Add(frameIndex);
+            }
+            for (SceneObjectId id : drawnObjects)
+            {
+                const std::shared_ptr<RenderableObject>& obj = sceneTree.Get(id);
+                sceneKey.Add(obj->GetVersion());
+                sceneKey.Add(obj->GetMesh()->GetVersion());
+                sceneKey.Add(obj->GetMaterial()->GetVersion());
+            }
+            if (!pipeline.BeginFrame(sceneKey.GetValue()))
+            {
+                // The color buffer still holds this frame
+                return;
+            }
+
+            for (SceneObjectId id : drawnObjects)
+            {
+                const std::shared_ptr<RenderableObject>& obj = sceneTree.Get(id);
+                pipeline.BindMaterial(obj->GetMaterial().get());
+                if (views.size() > 1)
+                {
+                    pipeline.DrawMultiView(*(obj->GetMesh()), obj->GetPosition(), views);
+                }
+                else
+                {
+                    pipeline.Draw(*(obj->GetMesh()), obj->GetPosition());
+                }
+            }
+            pipeline.EndFrame();
+        };
+
+        // With post effects the frame runs as a render graph whose composite pass writes postOutput
+        RenderGraph frameGraph;
+        std::vector<Vec3> postOutput;
+        if (HasPostEffects(options))
+        {
+            postOutput.resize(static_cast<size_t>(description.width) * description.height);
+            BuildFrameGraph(frameGraph, options, pipeline, renderScene, postOutput);
+        }
+
+        std::vector<uint8_t> displayPixels;
+        std::vector<double> frameTimesMs;
+        frameTimesMs.reserve(options.frameCount);
+
+        for (int frame = 0; frame < options.frameCount; ++frame)
+        {
+            PROFILE_SCOPE("Frame");
+            auto frameStart = std::chrono::steady_clock::now();
+
+            frameIndex = static_cast<uint64_t>(frame);
+            if (HasPostEffects(options))
+            {
+                frameGraph.Execute();
+                pipeline.ApplyPostProcess(postOutput, description.width, description.height, displayPixels);
+            }
+            else
+            {
+                renderScene();
+                pipeline.ResolveDisplayPixels(displayPixels);
+            }
+            int renderWidth = pipeline.GetRenderWidth();
+            int renderHeight = pipeline.GetRenderHeight();
+
+            auto frameEnd = std::chrono::steady_clock::now();
+            double frameMs = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+            frameTimesMs.push_back(frameMs);
+            if (renderWidth != description.width || renderHeight != description.height)
+            {
+                std::printf("frame %d: %.3f ms (rendered at %dx%d)\n", frame, frameMs, renderWidth, renderHeight);
+            }
+            else
+            {
+                std::printf("frame %d: %.3f ms\n", frame, frameMs);
+            }
+        }
+
+        double totalMs = 0.0;
+        for (double ms : frameTimesMs)
+        {
+            totalMs += ms;
+        }
+        auto minmax = std::minmax_element(frameTimesMs.begin(), frameTimesMs.end());
+        double averageMs = totalMs / frameTimesMs.size();
+        std::printf("%d frame(s) at %dx%d, %zu object(s): avg %.3f ms, min %.3f ms, max %.3f ms, %.2f fps\n",
+            options.frameCount, description.width, description.height, scene.objects.size(),
+            averageMs, *minmax.first, *minmax.second, 1000.0 / averageMs);
+
+        if (options.isPrintingStatistics)
+        {
+            PrintStatistics(pipeline.GetFrameStatistics());
+            std::printf("  post-process ms       %.3f\n", pipeline.GetLastPostProcessMs());
+            std::printf("objects drawn: %zu of %zu, scene BVH height %d\n",
+                drawnObjects.size(), sceneTree.GetObjectCount(), sceneTree.GetTreeHeight());
+
+            FrameArenaStats arena = pipeline.GetFrameArenaStats();
+            std::printf("frame memory: %.2f MB used, %.2f MB high-water mark, %.2f MB reserved\n",
+                arena.bytesUsed / (1024.0 * 1024.0), arena.highWaterMark / (1024.0 * 1024.0), arena.bytesReserved / (1024.0 * 1024.0));
+            if (HasPostEffects(options))
+            {
+                PrintRenderGraph(frameGraph);
+            }
+        }
+
+        ImageWriter::WriteImage(options.outputPath, description.width, description.height, displayPixels);
+        std::printf("wrote %s\n", options.outputPath.c_str());
+
+        if (!options.tracePath.empty())
+        {
+            Profiler::WriteChromeTrace(options.tracePath);
+            std::printf("wrote %s\n", options.tracePath.c_str());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -15,12 +15,27 @@ class IShader
 public:
     virtual ~IShader() = default;
 
-    virtual VertexOutput RunVertexShader(
+    // Vertex shading is split at world space: the world stage does not depend on the camera, so a multi-view
+    // draw runs it once and only the view stage once per view (see RenderPipeline::DrawMultiView)
+    virtual WorldVertex RunWorldStage(
         const VertexInput& input,
-        const Camera& camera,
         const Vec3& objectPosition
     ) const = 0;
 
+    virtual VertexOutput RunViewStage(
+        const WorldVertex& vertex,
+        const Camera& camera
+    ) const = 0;
+
+    VertexOutput RunVertexShader(
+        const VertexInput& input,
+        const Camera& camera,
+        const Vec3& objectPosition
+    ) const
+    {
+        return RunViewStage(RunWorldStage(input, objectPosition), camera);
+    }
+
     virtual Vec3 RunFragmentShader(
         const Fragment& fragment,
         const Camera& camera,
@@ -6,14 +6,120 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <map>
-#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include "ArrayView.h"
+#include "StateVersion.h"
+#include "Texture.h"
+#include "Vec3.h"
+
+struct IShaderProperties;
+
+enum class ShaderPropertyType
+{
+    Float,          // A float member
+    VectorComponent // One component of a Vec3 member, such as the red channel of a color
+};
+
+// One editable float of a shader, the same for every instance of its properties class.
+// The members are pointers to members of the concrete class converted to the base, so reading one is a fixed
+// offset from the object without knowing its type.
+struct ShaderPropertyDescriptor
+{
+    const char* name;
+    float minValue;
+    float maxValue;
+    ShaderPropertyType type;
+    float IShaderProperties::* scalar;
+    Vec3 IShaderProperties::* vector;
+    float Vec3::* component;
+};
 
 struct IShaderProperties
 {
     virtual ~IShaderProperties() = default;
 
     // UI-Driving Methods
-    virtual std::map<std::string, std::pair<float, float>> GetSliderProperties() const = 0;
+    // A static table, in slider order
+    virtual ArrayView<ShaderPropertyDescriptor> GetPropertyDescriptors() const = 0;
     virtual std::string GetShaderName() const = 0;
+
+    size_t GetPropertyCount() const { return GetPropertyDescriptors().size(); }
+
+    float GetProperty(size_t index) const
+    {
+        return const_cast<IShaderProperties*>(this)->_GetPropertyReference(GetPropertyDescriptors()[index]);
+    }
+
+    // Only bumps the version on a real change, so an untouched UI keeps hitting the frame cache
+    void SetProperty(size_t index, float value)
+    {
+        float& property = _GetPropertyReference(GetPropertyDescriptors()[index]);
+        if (property != value)
+        {
+            property = value;
+            MarkModified();
+        }
+    }
+
+    // Index of the named property, or -1 if the shader has none
+    int FindProperty(const std::string& name) const
+    {
+        ArrayView<ShaderPropertyDescriptor> descriptors = GetPropertyDescriptors();
+        for (size_t i = 0; i < descriptors.size(); ++i)
+        {
+            if (std::strcmp(descriptors[i].name, name.c_str()) == 0)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Call after changing any property so cached frames that used the old values are invalidated
+    void MarkModified() { _version = NextStateVersion(); }
+    uint64_t GetVersion() const { return _version; }
+
+    // Optional texture multiplied into the base color (Blinn-Phong diffuse, Toon base color), sampled with the mesh UVs
+    void SetBaseColorTexture(std::shared_ptr<const Texture> texture, TextureFilter filter = TextureFilter::Trilinear)
+    {
+        _baseColorTexture = std::move(texture);
+        _baseColorFilter = filter;
+        MarkModified();
+    }
+
+    const Texture* GetBaseColorTexture() const { return _baseColorTexture.get(); }
+    TextureFilter GetBaseColorFilter() const { return _baseColorFilter; }
+
+protected:
+    template <typename Properties>
+    static constexpr ShaderPropertyDescriptor _FloatProperty(const char* name, float minValue, float maxValue,
+        float Properties::* member)
+    {
+        return { name, minValue, maxValue, ShaderPropertyType::Float,
+            static_cast<float IShaderProperties::*>(member), nullptr, nullptr };
+    }
+
+    template <typename Properties>
+    static constexpr ShaderPropertyDescriptor _VectorProperty(const char* name, float minValue, float maxValue,
+        Vec3 Properties::* member, float Vec3::* component)
+    {
+        return { name, minValue, maxValue, ShaderPropertyType::VectorComponent,
+            nullptr, static_cast<Vec3 IShaderProperties::*>(member), component };
+    }
+
+private:
+    float& _GetPropertyReference(const ShaderPropertyDescriptor& descriptor)
+    {
+        if (descriptor.type == ShaderPropertyType::VectorComponent)
+        {
+            return (this->*descriptor.vector).*descriptor.component;
+        }
+        return this->*descriptor.scalar;
+    }
+
+    uint64_t _version = NextStateVersion();
+    std::shared_ptr<const Texture> _baseColorTexture;
+    TextureFilter _baseColorFilter = TextureFilter::Trilinear;
 };
\ No newline at end of file
@@ -0,0 +1,283 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "ImageWriter.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cctype>
+
+namespace
+{
+    uint32_t ComputeCrc32(const uint8_t* data, size_t length, uint32_t crc = 0)
+    {
+        static const std::array<uint32_t, 256> table = []()
+        {
+            std::array<uint32_t, 256> result{};
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                result[n] = c;
+            }
+            return result;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void AppendBigEndian32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void WriteChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data)
+    {
+        std::vector<uint8_t> chunk;
+        AppendBigEndian32(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        // The CRC covers the type and the data, not the length
+        AppendBigEndian32(chunk, ComputeCrc32(chunk.data() + 4, chunk.size() - 4));
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+
+    std::ofstream OpenForWrite(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("ImageWriter: Cannot open '" + path + "' for writing.");
+        }
+        return file;
+    }
+
+    // Running Adler-32, returns the checksum so far
+    uint32_t UpdateAdler32(uint32_t& a, uint32_t& b, const std::vector<uint8_t>& data)
+    {
+        for (uint8_t byte : data)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    void WriteRGB8(const std::string& path, int width, int height, const std::vector<uint8_t>& pixels)
+    {
+        ImageWriter::StreamWriter writer(path, width, height, ImageWriter::GetImageFormat(path));
+        writer.WriteRect(0, 0, width, height, pixels.data());
+        writer.Finish();
+    }
+}
+
+ImageWriter::ImageFormat ImageWriter::GetImageFormat(const std::string& path)
+{
+    std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".png")
+    {
+        return ImageFormat::PNG;
+    }
+    if (extension == ".ppm")
+    {
+        return ImageFormat::PPM;
+    }
+    throw std::runtime_error("ImageWriter: Unsupported image extension in '" + path + "', use .ppm or .png.");
+}
+
+ImageWriter::StreamWriter::StreamWriter(const std::string& path, int width, int height, ImageFormat format)
+    : _path(path),
+    _width(width),
+    _height(height),
+    _format(format)
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::runtime_error("ImageWriter: Image size must be positive.");
+    }
+    _file = OpenForWrite(path);
+
+    if (format == ImageFormat::PPM)
+    {
+        _file << "P6\n" << width << " " << height << "\n255\n";
+        _pixelsOffset = _file.tellp();
+        return;
+    }
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> header;
+    AppendBigEndian32(header, static_cast<uint32_t>(width));
+    AppendBigEndian32(header, static_cast<uint32_t>(height));
+    header.push_back(8); // Bit depth
+    header.push_back(2); // Color type: RGB
+    header.push_back(0); // Compression: deflate
+    header.push_back(0); // Filter method
+    header.push_back(0); // No interlace
+    _file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+    WriteChunk(_file, "IHDR", header);
+}
+
+void ImageWriter::StreamWriter::WriteRect(int x, int y, int width, int height, const uint8_t* rgbPixels)
+{
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > _width || y + height > _height)
+    {
+        throw std::runtime_error("ImageWriter: Rectangle outside of '" + _path + "'.");
+    }
+    const size_t rectRowBytes = static_cast<size_t>(width) * 3;
+    _pixelsWritten += static_cast<uint64_t>(width) * height;
+
+    if (_format == ImageFormat::PPM)
+    {
+        // Full-width rectangles are contiguous in the file
+        const int rowsPerWrite = (width == _width) ? height : 1;
+        for (int row = 0; row < height; row += rowsPerWrite)
+        {
+            uint64_t pixelIndex = static_cast<uint64_t>(y + row) * _width + x;
+            _file.seekp(_pixelsOffset + static_cast<std::streamoff>(pixelIndex * 3));
+            _file.write(reinterpret_cast<const char*>(rgbPixels + row * rectRowBytes), rectRowBytes * rowsPerWrite);
+        }
+        return;
+    }
+
+    // _bandY is the next row to write while no band is open
+    if (_bandHeight == 0 && y == _bandY)
+    {
+        _bandHeight = height;
+        _band.assign((static_cast<size_t>(_width) * 3 + 1) * height, 0); // Filter type 0 (None) on every row
+    }
+    if (y != _bandY || height != _bandHeight)
+    {
+        throw std::runtime_error("ImageWriter: PNG rectangles of '" + _path + "' must come band by band, top to bottom.");
+    }
+
+    const size_t bandRowBytes = static_cast<size_t>(_width) * 3 + 1;
+    for (int row = 0; row < height; ++row)
+    {
+        const uint8_t* source = rgbPixels + row * rectRowBytes;
+        std::copy(source, source + rectRowBytes, _band.begin() + row * bandRowBytes + 1 + static_cast<size_t>(x) * 3);
+    }
+    _bandPixelsWritten += static_cast<uint64_t>(width) * height;
+    if (_bandPixelsWritten == static_cast<uint64_t>(_width) * _bandHeight)
+    {
+        _WritePNGBand();
+    }
+}
+
+// One IDAT chunk per band, together one zlib stream of stored deflate blocks (max 65535 bytes each) with an
+// Adler-32 trailer
+void ImageWriter::StreamWriter::_WritePNGBand()
+{
+    const bool isFirstBand = _bandY == 0;
+    const bool isLastBand = _bandY + _bandHeight == _height;
+
+    std::vector<uint8_t> zlib;
+    if (isFirstBand)
+    {
+        zlib = { 0x78, 0x01 };
+    }
+    size_t offset = 0;
+    do
+    {
+        size_t blockSize = std::min<size_t>(65535, _band.size() - offset);
+        bool isFinal = isLastBand && offset + blockSize == _band.size();
+        zlib.push_back(isFinal ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(blockSize));
+        zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+        zlib.push_back(static_cast<uint8_t>(~blockSize));
+        zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+        zlib.insert(zlib.end(), _band.begin() + offset, _band.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < _band.size());
+
+    uint32_t adler = UpdateAdler32(_adlerA, _adlerB, _band);
+    if (isLastBand)
+    {
+        AppendBigEndian32(zlib, adler);
+    }
+    WriteChunk(_file, "IDAT", zlib);
+
+    _bandY += _bandHeight;
+    _bandHeight = 0;
+    _bandPixelsWritten = 0;
+}
+
+void ImageWriter::StreamWriter::Finish()
+{
+    if (_pixelsWritten != static_cast<uint64_t>(_width) * _height || (_format == ImageFormat::PNG && _bandY != _height))
+    {
+        throw std::runtime_error("ImageWriter: Not every pixel of '" + _path + "' was written.");
+    }
+    if (_format == ImageFormat::PNG)
+    {
+        WriteChunk(_file, "IEND", {});
+    }
+    _file.close();
+    if (!_file)
+    {
+        throw std::runtime_error("ImageWriter: Failed writing '" + _path + "'.");
+    }
+}
+
+void ImageWriter::ConvertToRGB8(const std::vector<Vec3>& colorBuffer, std::vector<uint8_t>& outPixels)
+{
+    outPixels.resize(colorBuffer.size() * 3);
+    for (size_t i = 0; i < colorBuffer.size(); ++i)
+    {
+        const Vec3& color = colorBuffer[i];
+        outPixels[i * 3 + 0] = static_cast<uint8_t>(std::max(0.0f, std::min(color.x, 1.0f)) * 255.0f);
+        outPixels[i * 3 + 1] = static_cast<uint8_t>(std::max(0.0f, std::min(color.y, 1.0f)) * 255.0f);
+        outPixels[i * 3 + 2] = static_cast<uint8_t>(std::max(0.0f, std::min(color.z, 1.0f)) * 255.0f);
+    }
+}
+
+void ImageWriter::WritePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbPixels)
+{
+    StreamWriter writer(path, width, height, ImageFormat::PPM);
+    writer.WriteRect(0, 0, width, height, rgbPixels.data());
+    writer.Finish();
+}
+
+void ImageWriter::WritePNG(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbPixels)
+{
+    StreamWriter writer(path, width, height, ImageFormat::PNG);
+    writer.WriteRect(0, 0, width, height, rgbPixels.data());
+    writer.Finish();
+}
+
+void ImageWriter::WriteImage(const std::string& path, int width, int height, const std::vector<Vec3>& colorBuffer)
+{
+    std::vector<uint8_t> pixels;
+    ConvertToRGB8(colorBuffer, pixels);
+    WriteRGB8(path, width, height, pixels);
+}
+
+void ImageWriter::WriteImage(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbaPixels)
+{
+    std::vector<uint8_t> pixels(rgbaPixels.size() / 4 * 3);
+    for (size_t i = 0; i < pixels.size() / 3; ++i)
+    {
+        pixels[i * 3 + 0] = rgbaPixels[i * 4 + 0];
+        pixels[i * 3 + 1] = rgbaPixels[i * 4 + 1];
+        pixels[i * 3 + 2] = rgbaPixels[i * 4 + 2];
+    }
+    WriteRGB8(path, width, height, pixels);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "Vec3.h"
+
+// Dependency-free image output for headless rendering
+namespace ImageWriter
+{
+    enum class ImageFormat
+    {
+        PPM, // Binary P6
+        PNG  // 8-bit RGB, uncompressed (stored) deflate blocks
+    };
+
+    // From the file extension, .ppm or .png
+    ImageFormat GetImageFormat(const std::string& path);
+
+    // Writes an 8-bit RGB image a rectangle at a time, so the whole image never has to be in memory.
+    // PPM rectangles go straight to their place in the file. PNG rows must be written in order, so a rectangle is
+    // held until the rest of its band of rows arrives: rectangles come band by band, top to bottom, and the
+    // rectangles of one band cover the same rows.
+    class StreamWriter
+    {
+    public:
+        StreamWriter(const std::string& path, int width, int height, ImageFormat format);
+
+        // Row-major, width * 3 bytes per row
+        void WriteRect(int x, int y, int width, int height, const uint8_t* rgbPixels);
+
+        // Throws std::runtime_error if any pixel was not written
+        void Finish();
+
+    private:
+        void _WritePNGBand();
+
+        std::string _path;
+        std::ofstream _file;
+        int _width;
+        int _height;
+        ImageFormat _format;
+        uint64_t _pixelsWritten = 0;
+
+        // PPM
+        std::streamoff _pixelsOffset = 0;
+
+        // PNG: the current band as raw scanlines, each prefixed with its filter type, and the Adler-32 so far
+        std::vector<uint8_t> _band;
+        int _bandY = 0;
+        int _bandHeight = 0;
+        uint64_t _bandPixelsWritten = 0;
+        uint32_t _adlerA = 1;
+        uint32_t _adlerB = 0;
+    };
+
+    // Clamp tonemapping like the previewer blit, 3 bytes per pixel
+    void ConvertToRGB8(const std::vector<Vec3>& colorBuffer, std::vector<uint8_t>& outPixels);
+
+    // Binary PPM (P6)
+    void WritePPM(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbPixels);
+
+    // 8-bit RGB PNG using uncompressed (stored) deflate blocks
+    void WritePNG(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbPixels);
+
+    // Picks PPM or PNG from the file extension
+    void WriteImage(const std::string& path, int width, int height, const std::vector<Vec3>& colorBuffer);
+
+    // RGBA8 as the post-processing stage writes it; alpha is dropped
+    void WriteImage(const std::string& path, int width, int height, const std::vector<uint8_t>& rgbaPixels);
+}
\ No newline at end of file
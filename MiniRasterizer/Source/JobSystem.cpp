@@ -0,0 +1,320 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "JobSystem.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include "Profiler.h"
+
+namespace
+{
+    // One ParallelFor call; lives on the caller's stack until remaining drops to 0
+    struct ParallelForTask
+    {
+        const std::function<void(size_t, size_t)>* body = nullptr;
+        size_t grainSize = 1;
+        std::atomic<size_t> remaining{ 0 }; // Items not finished yet
+        std::atomic<bool> hasFailed{ false };
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    struct Job
+    {
+        ParallelForTask* task;
+        size_t first;
+        size_t last;
+    };
+
+    // The owner pushes and pops at the back, thieves take from the front
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(int threadCount);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        int GetThreadCount() const { return static_cast<int>(_queues.size()); }
+
+        // Runs the task's range [0, count) and helps with other jobs until it is done
+        void Run(ParallelForTask& task, size_t count);
+
+    private:
+        void _WorkerLoop(size_t queueIndex);
+        void _Push(size_t queueIndex, const Job& job);
+        bool _TryPop(size_t queueIndex, Job& outJob);
+        void _Execute(size_t queueIndex, Job job);
+        size_t _GetQueueIndex() const;
+
+        // Queue 0 is shared by every thread outside the pool, queue i > 0 belongs to worker i
+        std::vector<std::unique_ptr<JobQueue>> _queues;
+        std::vector<std::thread> _workers;
+
+        // Jobs sitting in any queue, changed under the queue's mutex
+        std::atomic<int64_t> _queuedJobCount{ 0 };
+
+        std::mutex _sleepMutex;
+        std::condition_variable _wakeCondition;
+        bool _isStopping = false;
+    };
+
+    // Worker index of the current thread in the pool that started it, 0 outside any pool
+    thread_local const WorkerPool* t_pool = nullptr;
+    thread_local size_t t_queueIndex = 0;
+
+    WorkerPool::WorkerPool(int threadCount)
+    {
+        for (int i = 0; i < threadCount; ++i)
+        {
+            _queues.push_back(std::make_unique<JobQueue>());
+        }
+        for (int i = 1; i < threadCount; ++i)
+        {
+            _workers.emplace_back(&WorkerPool::_WorkerLoop, this, static_cast<size_t>(i));
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _isStopping = true;
+        }
+        _wakeCondition.notify_all();
+        for (std::thread& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t WorkerPool::_GetQueueIndex() const
+    {
+        return t_pool == this ? t_queueIndex : 0;
+    }
+
+    void WorkerPool::_Push(size_t queueIndex, const Job& job)
+    {
+        {
+            JobQueue& queue = *_queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(job);
+            _queuedJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Taking the sleep mutex orders this against a worker that checked the count and is about to wait
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _wakeCondition.notify_one();
+    }
+
+    bool WorkerPool::_TryPop(size_t queueIndex, Job& outJob)
+    {
+        if (_queuedJobCount.load(std::memory_order_relaxed) <= 0)
+        {
+            return false;
+        }
+
+        // Own queue first, newest job, which is the smallest and most likely still in cache
+        {
+            JobQueue& queue = *_queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                outJob = queue.jobs.back();
+                queue.jobs.pop_back();
+                _queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Then steal the oldest, largest job of another queue
+        for (size_t offset = 1; offset < _queues.size(); ++offset)
+        {
+            JobQueue& queue = *_queues[(queueIndex + offset) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                outJob = queue.jobs.front();
+                queue.jobs.pop_front();
+                _queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerPool::_Execute(size_t queueIndex, Job job)
+    {
+        ParallelForTask& task = *job.task;
+
+        // Leave the upper halves for thieves and keep splitting the lower one down to the grain
+        while (job.last - job.first > task.grainSize)
+        {
+            size_t middle = job.first + (job.last - job.first) / 2;
+            _Push(queueIndex, Job{ &task, middle, job.last });
+            job.last = middle;
+        }
+
+        if (!task.hasFailed.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                (*task.body)(job.first, job.last);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(task.errorMutex);
+                if (!task.error)
+                {
+                    task.error = std::current_exception();
+                }
+                task.hasFailed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        // The task may be gone once this reaches 0, so it is the last access
+        task.remaining.fetch_sub(job.last - job.first, std::memory_order_acq_rel);
+    }
+
+    void WorkerPool::Run(ParallelForTask& task, size_t count)
+    {
+        const size_t queueIndex = _GetQueueIndex();
+        task.remaining.store(count, std::memory_order_relaxed);
+        _Execute(queueIndex, Job{ &task, 0, count });
+
+        // Help out instead of blocking, the jobs run here may belong to other tasks
+        while (task.remaining.load(std::memory_order_acquire) != 0)
+        {
+            Job job;
+            if (_TryPop(queueIndex, job))
+            {
+                _Execute(queueIndex, job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void WorkerPool::_WorkerLoop(size_t queueIndex)
+    {
+        t_pool = this;
+        t_queueIndex = queueIndex;
+        Profiler::SetThreadName("Job Worker " + std::to_string(queueIndex));
+
+        while (true)
+        {
+            Job job;
+            if (_TryPop(queueIndex, job))
+            {
+                _Execute(queueIndex, job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _wakeCondition.wait(lock, [this]()
+            {
+                return _isStopping || _queuedJobCount.load(std::memory_order_relaxed) > 0;
+            });
+            if (_isStopping)
+            {
+                return;
+            }
+        }
+    }
+
+    int GetHardwareThreadCount()
+    {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    std::mutex g_poolMutex;
+
+    // Created on first use, so it is destroyed, and its workers joined, before the globals they use (the profiler's
+    // buffers) at exit
+    std::unique_ptr<WorkerPool>& GetPoolStorage()
+    {
+        static std::unique_ptr<WorkerPool> pool;
+        return pool;
+    }
+
+    WorkerPool& GetPool()
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        std::unique_ptr<WorkerPool>& pool = GetPoolStorage();
+        if (!pool)
+        {
+            pool = std::make_unique<WorkerPool>(GetHardwareThreadCount());
+        }
+        return *pool;
+    }
+}
+
+void JobSystem::SetThreadCount(int threadCount)
+{
+    if (threadCount < 0)
+    {
+        throw std::runtime_error("JobSystem: Thread count must not be negative.");
+    }
+    int resolvedCount = threadCount == 0 ? GetHardwareThreadCount() : threadCount;
+
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    std::unique_ptr<WorkerPool>& pool = GetPoolStorage();
+    if (pool && pool->GetThreadCount() == resolvedCount)
+    {
+        return;
+    }
+    pool.reset();
+    pool = std::make_unique<WorkerPool>(resolvedCount);
+}
+
+int JobSystem::GetThreadCount()
+{
+    return GetPool().GetThreadCount();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+
+    WorkerPool& pool = GetPool();
+    if (pool.GetThreadCount() == 1 || count <= grainSize)
+    {
+        body(0, count);
+        return;
+    }
+
+    ParallelForTask task;
+    task.body = &body;
+    task.grainSize = grainSize;
+    pool.Run(task, count);
+    if (task.error)
+    {
+        std::rethrow_exception(task.error);
+    }
+}
\ No newline at end of file
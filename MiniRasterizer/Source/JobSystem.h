@@ -0,0 +1,28 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+
+// Engine-wide work-stealing job system.
+//
+// Persistent workers, one per core beside the calling thread, each own a deque of jobs. A job covering more than
+// its grain splits itself in half, pushes the upper half onto the back of its worker's deque and keeps the lower
+// half; idle workers steal from the front of the other deques, where the largest halves sit. A thread waiting
+// for its ParallelFor runs jobs too, so nested ParallelFor calls (a render graph pass drawing with a parallel
+// pipeline) never block a worker. With one thread everything runs inline on the caller.
+namespace JobSystem
+{
+    // Total threads including the caller, 0 picks one per hardware thread. Stops the old workers first, so it must
+    // not be called while a ParallelFor is running. Defaults to one per hardware thread.
+    void SetThreadCount(int threadCount);
+    int GetThreadCount();
+
+    // Calls body(first, last) over disjoint ranges that together cover [0, count), each at most grainSize long
+    // unless it runs inline. Returns when every range is done; the first exception thrown by body is rethrown here,
+    // ranges not yet started are skipped after it.
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+}
\ No newline at end of file
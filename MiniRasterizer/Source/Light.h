@@ -10,4 +10,14 @@ struct Light
 {
     Vec3 position;
     Vec3 color;
+
+    bool operator==(const Light& other) const
+    {
+        return position == other.position && color == other.color;
+    }
+
+    bool operator!=(const Light& other) const
+    {
+        return !(*this == other);
+    }
 };
\ No newline at end of file
@@ -9,6 +9,9 @@
 #include <memory>
 #include <utility>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include "StateVersion.h"
 
 class Material
 {
@@ -31,6 +34,7 @@ public:
         }
         _shader = std::move(shader);
         _properties = _shader->CreateProperties();
+        _version = NextStateVersion();
     }
 
     const IShader* GetShader() const
@@ -43,7 +47,31 @@ public:
         return _properties.get();
     }
 
+    // Coarse rates run the fragment shader once per block of pixels and reuse the color for the whole block.
+    // Coverage and depth stay per pixel, so edges keep full resolution; suited to low-frequency materials.
+    void SetShadingRate(ShadingRate rate)
+    {
+        if (rate != _shadingRate)
+        {
+            _shadingRate = rate;
+            _version = NextStateVersion();
+        }
+    }
+
+    ShadingRate GetShadingRate() const
+    {
+        return _shadingRate;
+    }
+
+    // Changes when the shader is swapped, the shading rate changes or any property is modified
+    uint64_t GetVersion() const
+    {
+        return std::max(_version, _properties->GetVersion());
+    }
+
 private:
     std::shared_ptr<IShader> _shader;
     std::unique_ptr<IShaderProperties> _properties;
+    ShadingRate _shadingRate = ShadingRate::Rate1x1;
+    uint64_t _version = NextStateVersion();
 };
\ No newline at end of file
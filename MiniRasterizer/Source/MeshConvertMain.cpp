@@ -0,0 +1,71 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+// Converts Wavefront OBJ files to the binary .mrmesh format that MeshFile::Load maps without parsing.
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+#include "MeshFile.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout <<
+            "Usage: MiniRasterizerMeshConvert <input.obj> <output.mrmesh> [--meshlets]\n"
+            "  --meshlets   Also store meshlets of up to 128 triangles with their bounds\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        std::string inputPath;
+        std::string outputPath;
+        bool isBuildingMeshlets = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                PrintUsage();
+                return 0;
+            }
+            if (arg == "--meshlets") { isBuildingMeshlets = true; }
+            else if (inputPath.empty()) { inputPath = arg; }
+            else if (outputPath.empty()) { outputPath = arg; }
+            else { throw std::runtime_error("Unexpected argument '" + arg + "', see --help."); }
+        }
+        if (outputPath.empty())
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto mesh = MeshFile::ImportOBJ(inputPath, isBuildingMeshlets);
+        MeshFile::Save(outputPath, *mesh);
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("wrote %s: %zu vertices, %zu triangles, %zu meshlets, %s (%.1f ms)\n",
+            outputPath.c_str(),
+            mesh->GetPositions().size(),
+            mesh->GetIndices().size() / 3,
+            mesh->GetMeshlets().size(),
+            mesh->GetUVs().empty() ? "no uvs" : "uvs",
+            elapsedMs);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
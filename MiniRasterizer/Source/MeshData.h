@@ -7,27 +7,122 @@
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include "ArrayView.h"
+#include "Vec2.h"
 #include "Vec3.h"
+#include "StateVersion.h"
 
+struct MeshBounds
+{
+    Vec3 min;
+    Vec3 max;
+};
+
+// A contiguous run of triangles and its bounds, so whole groups of triangles can be rejected at once
+struct Meshlet
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    MeshBounds bounds;
+};
+
+// 16 bits per axis, spread over the mesh bounds
+struct QuantizedPosition
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+};
+
+// The streams of one mesh, as views.
+// A quantized mesh (see MeshQuantization) fills quantizedPositions and octahedralNormals instead of positions and
+// normals, and shortIndices instead of indices when every index fits in 16 bits.
+struct MeshStreams
+{
+    ArrayView<Vec3> positions;
+    ArrayView<Vec3> normals;
+    ArrayView<Vec2> uvs; // Empty when the mesh has no texture coordinates
+    ArrayView<unsigned int> indices;
+    ArrayView<Meshlet> meshlets; // Optional
+
+    ArrayView<QuantizedPosition> quantizedPositions;
+    ArrayView<uint32_t> octahedralNormals; // Two 16-bit snorm octahedron coordinates
+    ArrayView<uint16_t> shortIndices;
+};
+
+// Immutable geometry. The streams either live in vectors owned by the mesh or view memory owned by someone else,
+// such as a mapped mesh file (see MeshFile). Either way the owner is kept alive by the mesh and shared by its copies.
 class MeshData
 {
 private:
-    std::vector<Vec3> _positions;
-    std::vector<Vec3> _normals;
-    std::vector<unsigned int> _indices;
+    struct OwnedStreams
+    {
+        std::vector<Vec3> positions;
+        std::vector<Vec3> normals;
+        std::vector<Vec2> uvs;
+        std::vector<unsigned int> indices;
+        std::vector<Meshlet> meshlets;
+    };
 
-public:
-    MeshData(std::vector<Vec3> positions,
-        std::vector<Vec3> normals,
-        std::vector<unsigned int> indices)
-        : _positions(std::move(positions)),
-        _normals(std::move(normals)),
-        _indices(std::move(indices))
+    std::shared_ptr<const void> _storage;
+    MeshStreams _streams;
+    MeshBounds _bounds;
+    uint64_t _version = NextStateVersion(); // Geometry is immutable, so this doubles as an identity
+
+    void _Validate() const
     {
-        if (_positions.size() != _normals.size())
+        if (_streams.positions.size() != _streams.normals.size() ||
+            _streams.quantizedPositions.size() != _streams.octahedralNormals.size())
         {
             throw std::runtime_error("MeshData: Positions and normals count mismatch.");
         }
+        if (!_streams.positions.empty() && !_streams.quantizedPositions.empty())
+        {
+            throw std::runtime_error("MeshData: Mesh has both float and quantized positions.");
+        }
+        if (!_streams.indices.empty() && !_streams.shortIndices.empty())
+        {
+            throw std::runtime_error("MeshData: Mesh has both 32-bit and 16-bit indices.");
+        }
+        if (!_streams.uvs.empty() && _streams.uvs.size() != GetVertexCount())
+        {
+            throw std::runtime_error("MeshData: Positions and UVs count mismatch.");
+        }
+    }
+
+public:
+    MeshData(std::vector<Vec3> positions,
+        std::vector<Vec3> normals,
+        std::vector<unsigned int> indices,
+        std::vector<Vec2> uvs = {},
+        std::vector<Meshlet> meshlets = {})
+    {
+        auto owned = std::make_shared<OwnedStreams>();
+        owned->positions = std::move(positions);
+        owned->normals = std::move(normals);
+        owned->uvs = std::move(uvs);
+        owned->indices = std::move(indices);
+        owned->meshlets = std::move(meshlets);
+
+        _streams.positions = owned->positions;
+        _streams.normals = owned->normals;
+        _streams.uvs = owned->uvs;
+        _streams.indices = owned->indices;
+        _streams.meshlets = owned->meshlets;
+        _bounds = ComputeBounds(_streams.positions);
+        _storage = std::move(owned);
+        _Validate();
+    }
+
+    // Zero-copy: the streams point into memory owned by storage
+    MeshData(std::shared_ptr<const void> storage, const MeshStreams& streams, const MeshBounds& bounds)
+        : _storage(std::move(storage)),
+        _streams(streams),
+        _bounds(bounds)
+    {
+        _Validate();
     }
 
     ~MeshData() = default;
@@ -36,18 +131,88 @@ public:
     MeshData& operator=(const MeshData&) = default;
     MeshData& operator=(MeshData&&) = default;
 
-    const std::vector<Vec3>& GetPositions() const
+    // Empty for a quantized mesh, see GetStreams()
+    ArrayView<Vec3> GetPositions() const
+    {
+        return _streams.positions;
+    }
+
+    ArrayView<Vec3> GetNormals() const
+    {
+        return _streams.normals;
+    }
+
+    ArrayView<Vec2> GetUVs() const
+    {
+        return _streams.uvs;
+    }
+
+    // Empty when the mesh uses 16-bit indices
+    ArrayView<unsigned int> GetIndices() const
+    {
+        return _streams.indices;
+    }
+
+    ArrayView<Meshlet> GetMeshlets() const
+    {
+        return _streams.meshlets;
+    }
+
+    const MeshStreams& GetStreams() const
+    {
+        return _streams;
+    }
+
+    bool IsQuantized() const
     {
-        return _positions;
+        return !_streams.quantizedPositions.empty();
     }
 
-    const std::vector<Vec3>& GetNormals() const
+    size_t GetVertexCount() const
     {
-        return _normals;
+        return IsQuantized() ? _streams.quantizedPositions.size() : _streams.positions.size();
     }
 
-    const std::vector<unsigned int>& GetIndices() const
+    size_t GetIndexCount() const
     {
-        return _indices;
+        return _streams.shortIndices.empty() ? _streams.indices.size() : _streams.shortIndices.size();
+    }
+
+    // Memory held by the vertex and index streams
+    size_t GetStreamBytes() const
+    {
+        return _streams.positions.size() * sizeof(Vec3) +
+            _streams.normals.size() * sizeof(Vec3) +
+            _streams.uvs.size() * sizeof(Vec2) +
+            _streams.indices.size() * sizeof(unsigned int) +
+            _streams.quantizedPositions.size() * sizeof(QuantizedPosition) +
+            _streams.octahedralNormals.size() * sizeof(uint32_t) +
+            _streams.shortIndices.size() * sizeof(uint16_t);
+    }
+
+    const MeshBounds& GetBounds() const
+    {
+        return _bounds;
+    }
+
+    uint64_t GetVersion() const
+    {
+        return _version;
+    }
+
+    static MeshBounds ComputeBounds(ArrayView<Vec3> positions)
+    {
+        MeshBounds bounds;
+        if (positions.empty())
+        {
+            return bounds;
+        }
+        bounds.min = bounds.max = positions[0];
+        for (const Vec3& p : positions)
+        {
+            bounds.min = Vec3(std::min(bounds.min.x, p.x), std::min(bounds.min.y, p.y), std::min(bounds.min.z, p.z));
+            bounds.max = Vec3(std::max(bounds.max.x, p.x), std::max(bounds.max.y, p.y), std::max(bounds.max.z, p.z));
+        }
+        return bounds;
     }
 };
\ No newline at end of file
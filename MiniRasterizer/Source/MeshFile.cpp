@@ -0,0 +1,512 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "MeshFile.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(Vec2) == 8 && sizeof(Vec3) == 12, "Mesh files store Vec2 and Vec3 as packed floats");
+static_assert(sizeof(Meshlet) == 32, "Mesh files store Meshlet as two uint32 and six floats");
+
+namespace
+{
+    constexpr char MAGIC[4] = { 'M', 'R', 'M', 'S' };
+    constexpr uint32_t FLAG_HAS_UVS = 1u << 0;
+    constexpr uint64_t STREAM_ALIGNMENT = 16;
+
+    struct MeshFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t flags;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t meshletCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t positionsOffset;
+        uint64_t normalsOffset;
+        uint64_t uvsOffset;
+        uint64_t indicesOffset;
+        uint64_t meshletsOffset;
+    };
+
+    // Read-only mapping of a whole file, unmapped on destruction
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#if defined(_WIN32)
+            _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (_file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("MeshFile: Failed to open '" + path + "'.");
+            }
+            LARGE_INTEGER size;
+            GetFileSizeEx(_file, &size);
+            _size = static_cast<size_t>(size.QuadPart);
+            if (_size > 0)
+            {
+                _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                _data = _mapping ? static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            }
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("MeshFile: Failed to open '" + path + "'.");
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0)
+            {
+                _size = static_cast<size_t>(info.st_size);
+            }
+            if (_size > 0)
+            {
+                void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                _data = (data == MAP_FAILED) ? nullptr : static_cast<const unsigned char*>(data);
+            }
+            close(fd); // The mapping keeps its own reference to the file
+#endif
+            if (_size > 0 && !_data)
+            {
+                _Release();
+                throw std::runtime_error("MeshFile: Failed to map '" + path + "'.");
+            }
+        }
+
+        ~MappedFile()
+        {
+            _Release();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* GetData() const { return _data; }
+        size_t GetSize() const { return _size; }
+
+    private:
+        void _Release()
+        {
+#if defined(_WIN32)
+            if (_data)
+            {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping)
+            {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(_file);
+            }
+#else
+            if (_data)
+            {
+                munmap(const_cast<unsigned char*>(_data), _size);
+            }
+#endif
+            _data = nullptr;
+        }
+
+#if defined(_WIN32)
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = nullptr;
+#endif
+        const unsigned char* _data = nullptr;
+        size_t _size = 0;
+    };
+
+    // Points a view at one stream of the mapping after checking it is inside the file and aligned
+    template <typename T>
+    ArrayView<T> ViewStream(const MappedFile& file, uint64_t offset, uint64_t count, const std::string& path)
+    {
+        if (count == 0)
+        {
+            return ArrayView<T>();
+        }
+        if (offset % alignof(T) != 0 || offset > file.GetSize() || count > (file.GetSize() - offset) / sizeof(T))
+        {
+            throw std::runtime_error("MeshFile: '" + path + "' has a stream outside the file.");
+        }
+        return ArrayView<T>(reinterpret_cast<const T*>(file.GetData() + offset), static_cast<size_t>(count));
+    }
+
+    uint64_t AlignStream(uint64_t offset)
+    {
+        return (offset + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+    }
+
+    template <typename T>
+    void WriteStream(std::ofstream& file, uint64_t offset, ArrayView<T> stream)
+    {
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        static const char padding[STREAM_ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        file.write(reinterpret_cast<const char*>(stream.data()), static_cast<std::streamsize>(stream.size() * sizeof(T)));
+    }
+
+    // OBJ indices are 1-based, negative ones count back from the last element read so far
+    bool ResolveOBJIndex(long index, size_t count, int& outIndex)
+    {
+        long resolved = index > 0 ? index - 1 : static_cast<long>(count) + index;
+        if (index == 0 || resolved < 0 || resolved >= static_cast<long>(count))
+        {
+            return false;
+        }
+        outIndex = static_cast<int>(resolved);
+        return true;
+    }
+
+    struct OBJCorner
+    {
+        int position = -1;
+        int uv = -1;
+        int normal = -1;
+
+        bool operator==(const OBJCorner& other) const
+        {
+            return position == other.position && uv == other.uv && normal == other.normal;
+        }
+    };
+
+    struct OBJCornerHash
+    {
+        size_t operator()(const OBJCorner& corner) const
+        {
+            uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(corner.position)) * 0x9E3779B97F4A7C15ull;
+            key ^= static_cast<uint64_t>(static_cast<uint32_t>(corner.uv)) * 0xC2B2AE3D27D4EB4Full + (key >> 29);
+            key ^= static_cast<uint64_t>(static_cast<uint32_t>(corner.normal)) * 0x165667B19E3779F9ull + (key >> 32);
+            return static_cast<size_t>(key);
+        }
+    };
+}
+
+namespace MeshFile
+{
+    std::shared_ptr<MeshData> Load(const std::string& path)
+    {
+        auto file = std::make_shared<MappedFile>(path);
+
+        MeshFileHeader header;
+        if (file->GetSize() < sizeof(header))
+        {
+            throw std::runtime_error("MeshFile: '" + path + "' is too small to be a mesh file.");
+        }
+        std::memcpy(&header, file->GetData(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error("MeshFile: '" + path + "' is not a mesh file.");
+        }
+        if (header.version != FORMAT_VERSION)
+        {
+            throw std::runtime_error("MeshFile: '" + path + "' has format version " + std::to_string(header.version) +
+                ", expected " + std::to_string(FORMAT_VERSION) + ".");
+        }
+
+        MeshStreams streams;
+        streams.positions = ViewStream<Vec3>(*file, header.positionsOffset, header.vertexCount, path);
+        streams.normals = ViewStream<Vec3>(*file, header.normalsOffset, header.vertexCount, path);
+        if (header.flags & FLAG_HAS_UVS)
+        {
+            streams.uvs = ViewStream<Vec2>(*file, header.uvsOffset, header.vertexCount, path);
+        }
+        streams.indices = ViewStream<unsigned int>(*file, header.indicesOffset, header.indexCount, path);
+        streams.meshlets = ViewStream<Meshlet>(*file, header.meshletsOffset, header.meshletCount, path);
+
+        MeshBounds bounds;
+        bounds.min = Vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        bounds.max = Vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        return std::make_shared<MeshData>(std::move(file), streams, bounds);
+    }
+
+    void Save(const std::string& path, const MeshData& mesh)
+    {
+        if (mesh.IsQuantized() || !mesh.GetStreams().shortIndices.empty())
+        {
+            throw std::runtime_error("MeshFile: Quantized meshes cannot be saved, save the float mesh instead: " + path);
+        }
+        const MeshStreams& streams = mesh.GetStreams();
+        const MeshBounds& bounds = mesh.GetBounds();
+
+        MeshFileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.flags = streams.uvs.empty() ? 0 : FLAG_HAS_UVS;
+        header.vertexCount = static_cast<uint32_t>(streams.positions.size());
+        header.indexCount = static_cast<uint32_t>(streams.indices.size());
+        header.meshletCount = static_cast<uint32_t>(streams.meshlets.size());
+        header.boundsMin[0] = bounds.min.x;
+        header.boundsMin[1] = bounds.min.y;
+        header.boundsMin[2] = bounds.min.z;
+        header.boundsMax[0] = bounds.max.x;
+        header.boundsMax[1] = bounds.max.y;
+        header.boundsMax[2] = bounds.max.z;
+
+        header.positionsOffset = AlignStream(sizeof(header));
+        header.normalsOffset = AlignStream(header.positionsOffset + streams.positions.size() * sizeof(Vec3));
+        header.uvsOffset = AlignStream(header.normalsOffset + streams.normals.size() * sizeof(Vec3));
+        header.indicesOffset = AlignStream(header.uvsOffset + streams.uvs.size() * sizeof(Vec2));
+        header.meshletsOffset = AlignStream(header.indicesOffset + streams.indices.size() * sizeof(unsigned int));
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("MeshFile: Failed to open '" + path + "' for writing.");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteStream(file, header.positionsOffset, streams.positions);
+        WriteStream(file, header.normalsOffset, streams.normals);
+        WriteStream(file, header.uvsOffset, streams.uvs);
+        WriteStream(file, header.indicesOffset, streams.indices);
+        WriteStream(file, header.meshletsOffset, streams.meshlets);
+        if (!file)
+        {
+            throw std::runtime_error("MeshFile: Failed to write '" + path + "'.");
+        }
+    }
+
+    std::shared_ptr<MeshData> ImportOBJ(const std::string& path, bool isBuildingMeshlets)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("MeshFile: Failed to open '" + path + "'.");
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const std::string text = buffer.str();
+
+        std::vector<Vec3> objPositions;
+        std::vector<Vec2> objUVs;
+        std::vector<Vec3> objNormals;
+
+        std::vector<Vec3> positions;
+        std::vector<Vec3> normals;
+        std::vector<Vec2> uvs;
+        std::vector<unsigned int> indices;
+        std::vector<uint8_t> isNormalMissing;
+        std::unordered_map<OBJCorner, unsigned int, OBJCornerHash> vertexIndices;
+        std::vector<unsigned int> face;
+
+        size_t lineNumber = 0;
+        const char* cursor = text.c_str();
+        const char* textEnd = cursor + text.size();
+        while (cursor < textEnd)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', textEnd - cursor));
+            if (!lineEnd)
+            {
+                lineEnd = textEnd;
+            }
+            ++lineNumber;
+            std::string line(cursor, lineEnd);
+            cursor = lineEnd + 1;
+
+            const char* p = line.c_str();
+            while (*p == ' ' || *p == '\t')
+            {
+                ++p;
+            }
+            auto fail = [&]()
+            {
+                throw std::runtime_error("MeshFile: '" + path + "' line " + std::to_string(lineNumber) + ": Malformed statement.");
+            };
+            auto readFloat = [&](const char*& s)
+            {
+                char* end;
+                float value = std::strtof(s, &end);
+                if (end == s)
+                {
+                    fail();
+                }
+                s = end;
+                return value;
+            };
+
+            if (p[0] == 'v' && p[1] == ' ')
+            {
+                p += 2;
+                float x = readFloat(p);
+                float y = readFloat(p);
+                float z = readFloat(p);
+                objPositions.emplace_back(x, y, z);
+            }
+            else if (p[0] == 'v' && p[1] == 't' && p[2] == ' ')
+            {
+                p += 3;
+                float u = readFloat(p);
+                float v = readFloat(p);
+                objUVs.emplace_back(u, v);
+            }
+            else if (p[0] == 'v' && p[1] == 'n' && p[2] == ' ')
+            {
+                p += 3;
+                float x = readFloat(p);
+                float y = readFloat(p);
+                float z = readFloat(p);
+                objNormals.emplace_back(x, y, z);
+            }
+            else if (p[0] == 'f' && p[1] == ' ')
+            {
+                p += 2;
+                face.clear();
+                while (true)
+                {
+                    while (*p == ' ' || *p == '\t' || *p == '\r')
+                    {
+                        ++p;
+                    }
+                    if (*p == '\0')
+                    {
+                        break;
+                    }
+
+                    // v, v/vt, v//vn or v/vt/vn
+                    OBJCorner corner;
+                    char* end;
+                    if (!ResolveOBJIndex(std::strtol(p, &end, 10), objPositions.size(), corner.position))
+                    {
+                        fail();
+                    }
+                    p = end;
+                    if (*p == '/')
+                    {
+                        ++p;
+                        if (*p != '/')
+                        {
+                            if (!ResolveOBJIndex(std::strtol(p, &end, 10), objUVs.size(), corner.uv))
+                            {
+                                fail();
+                            }
+                            p = end;
+                        }
+                        if (*p == '/')
+                        {
+                            ++p;
+                            if (!ResolveOBJIndex(std::strtol(p, &end, 10), objNormals.size(), corner.normal))
+                            {
+                                fail();
+                            }
+                            p = end;
+                        }
+                    }
+
+                    auto inserted = vertexIndices.emplace(corner, static_cast<unsigned int>(positions.size()));
+                    if (inserted.second)
+                    {
+                        positions.push_back(objPositions[corner.position]);
+                        normals.push_back(corner.normal >= 0 ? objNormals[corner.normal] : Vec3());
+                        uvs.push_back(corner.uv >= 0 ? objUVs[corner.uv] : Vec2());
+                        isNormalMissing.push_back(corner.normal < 0 ? 1 : 0);
+                    }
+                    face.push_back(inserted.first->second);
+                }
+
+                if (face.size() < 3)
+                {
+                    fail();
+                }
+                for (size_t i = 1; i + 1 < face.size(); ++i)
+                {
+                    indices.push_back(face[0]);
+                    indices.push_back(face[i]);
+                    indices.push_back(face[i + 1]);
+                }
+            }
+        }
+
+        // Area-weighted average of the adjacent face normals for vertices the file gave none
+        if (std::find(isNormalMissing.begin(), isNormalMissing.end(), 1) != isNormalMissing.end())
+        {
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                const Vec3& a = positions[indices[i]];
+                Vec3 e0 = positions[indices[i + 1]] - a;
+                Vec3 e1 = positions[indices[i + 2]] - a;
+                Vec3 faceNormal(e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x);
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    unsigned int vertex = indices[i + corner];
+                    if (isNormalMissing[vertex])
+                    {
+                        normals[vertex] = normals[vertex] + faceNormal;
+                    }
+                }
+            }
+            for (size_t i = 0; i < normals.size(); ++i)
+            {
+                if (isNormalMissing[i])
+                {
+                    normals[i] = normals[i].normalize();
+                }
+            }
+        }
+
+        if (objUVs.empty())
+        {
+            uvs.clear();
+        }
+
+        std::vector<Meshlet> meshlets;
+        if (isBuildingMeshlets)
+        {
+            meshlets = BuildMeshlets(positions, indices);
+        }
+        return std::make_shared<MeshData>(std::move(positions), std::move(normals), std::move(indices), std::move(uvs), std::move(meshlets));
+    }
+
+    std::vector<Meshlet> BuildMeshlets(ArrayView<Vec3> positions, ArrayView<unsigned int> indices)
+    {
+        std::vector<Meshlet> meshlets;
+        const size_t indicesPerMeshlet = MESHLET_MAX_TRIANGLES * 3;
+        for (size_t first = 0; first + 3 <= indices.size(); first += indicesPerMeshlet)
+        {
+            Meshlet meshlet;
+            meshlet.firstIndex = static_cast<uint32_t>(first);
+            meshlet.indexCount = static_cast<uint32_t>(std::min(indicesPerMeshlet, (indices.size() - first) / 3 * 3));
+            meshlet.bounds = MeshBounds();
+
+            bool isFirstVertex = true;
+            for (size_t i = first; i < first + meshlet.indexCount; ++i)
+            {
+                if (indices[i] >= positions.size())
+                {
+                    continue;
+                }
+                const Vec3& p = positions[indices[i]];
+                if (isFirstVertex)
+                {
+                    meshlet.bounds.min = meshlet.bounds.max = p;
+                    isFirstVertex = false;
+                    continue;
+                }
+                meshlet.bounds.min = Vec3(std::min(meshlet.bounds.min.x, p.x), std::min(meshlet.bounds.min.y, p.y), std::min(meshlet.bounds.min.z, p.z));
+                meshlet.bounds.max = Vec3(std::max(meshlet.bounds.max.x, p.x), std::max(meshlet.bounds.max.y, p.y), std::max(meshlet.bounds.max.z, p.z));
+            }
+            meshlets.push_back(meshlet);
+        }
+        return meshlets;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "MeshData.h"
+
+// Binary mesh files (.mrmesh) that load by memory-mapping instead of parsing.
+//
+// Layout, little-endian, every stream starting on a 16-byte boundary:
+//   header    magic "MRMS", format version, flags, vertex/index/meshlet counts, bounds, byte offset of each stream
+//   positions vertexCount x Vec3
+//   normals   vertexCount x Vec3
+//   uvs       vertexCount x Vec2, only with the has-UVs flag
+//   indices   indexCount x uint32
+//   meshlets  meshletCount x Meshlet
+// The streams are stored exactly as MeshData views them, so a loaded mesh points straight into the mapping and
+// pages are faulted in as the pipeline first reads them.
+namespace MeshFile
+{
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint32_t MESHLET_MAX_TRIANGLES = 128;
+
+    // Zero-copy; the mapping lives as long as the mesh and its copies. Throws std::runtime_error on a malformed file.
+    // Indices are not range-checked here, the pipeline already drops triangles with out-of-range indices.
+    std::shared_ptr<MeshData> Load(const std::string& path);
+
+    // Writes the mesh, including its meshlets if it has any
+    void Save(const std::string& path, const MeshData& mesh);
+
+    // Wavefront OBJ: v, vt, vn and f; polygons are split into triangle fans and missing normals are computed
+    // by averaging the adjacent face normals. Other statements are ignored.
+    std::shared_ptr<MeshData> ImportOBJ(const std::string& path, bool isBuildingMeshlets = false);
+
+    // Cuts the index stream, in order, into runs of at most MESHLET_MAX_TRIANGLES triangles
+    std::vector<Meshlet> BuildMeshlets(ArrayView<Vec3> positions, ArrayView<unsigned int> indices);
+}
\ No newline at end of file
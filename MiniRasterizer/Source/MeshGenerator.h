@@ -17,6 +17,7 @@ namespace MeshGenerator
     {
         std::vector<Vec3> positions;
         std::vector<Vec3> normals;
+        std::vector<Vec2> uvs;
         std::vector<unsigned int> indices;
 
         // === 1. Generate Vertices and Normals ===
@@ -36,6 +37,7 @@ namespace MeshGenerator
 
                 positions.emplace_back(xPos + posOffset.x, yPos + posOffset.y, zPos + posOffset.z);
                 normals.emplace_back(Vec3(xPos, yPos, zPos).normalize());
+                uvs.emplace_back(static_cast<float>(x) / segments, static_cast<float>(y) / segments);
             }
         }
 
@@ -66,6 +68,6 @@ namespace MeshGenerator
             }
         }
 
-        return std::make_shared<MeshData>(std::move(positions), std::move(normals), std::move(indices));
+        return std::make_shared<MeshData>(std::move(positions), std::move(normals), std::move(indices), std::move(uvs));
     }
 }
\ No newline at end of file
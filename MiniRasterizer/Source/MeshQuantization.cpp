@@ -0,0 +1,71 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "MeshQuantization.h"
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    struct QuantizedStreams
+    {
+        std::vector<QuantizedPosition> positions;
+        std::vector<uint32_t> normals;
+        std::vector<Vec2> uvs;
+        std::vector<unsigned int> indices;
+        std::vector<uint16_t> shortIndices;
+        std::vector<Meshlet> meshlets;
+    };
+}
+
+namespace MeshQuantization
+{
+    std::shared_ptr<MeshData> Quantize(const MeshData& mesh)
+    {
+        if (mesh.IsQuantized())
+        {
+            throw std::runtime_error("MeshQuantization: Mesh is already quantized.");
+        }
+
+        const MeshStreams& source = mesh.GetStreams();
+        const MeshBounds& bounds = mesh.GetBounds();
+        auto owned = std::make_shared<QuantizedStreams>();
+
+        owned->positions.reserve(source.positions.size());
+        owned->normals.reserve(source.normals.size());
+        for (size_t i = 0; i < source.positions.size(); ++i)
+        {
+            owned->positions.push_back(EncodePosition(source.positions[i], bounds));
+            owned->normals.push_back(EncodeNormal(source.normals[i]));
+        }
+        owned->uvs.assign(source.uvs.begin(), source.uvs.end());
+        owned->meshlets.assign(source.meshlets.begin(), source.meshlets.end());
+
+        // Out-of-range indices are dropped by the pipeline, keep them out of range rather than wrapping them
+        if (source.positions.size() <= std::numeric_limits<uint16_t>::max())
+        {
+            owned->shortIndices.reserve(source.indices.size());
+            for (unsigned int index : source.indices)
+            {
+                owned->shortIndices.push_back(static_cast<uint16_t>(
+                    std::min<unsigned int>(index, std::numeric_limits<uint16_t>::max())));
+            }
+        }
+        else
+        {
+            owned->indices.assign(source.indices.begin(), source.indices.end());
+        }
+
+        MeshStreams streams;
+        streams.quantizedPositions = owned->positions;
+        streams.octahedralNormals = owned->normals;
+        streams.uvs = owned->uvs;
+        streams.indices = owned->indices;
+        streams.shortIndices = owned->shortIndices;
+        streams.meshlets = owned->meshlets;
+        return std::make_shared<MeshData>(std::move(owned), streams, bounds);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <memory>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "MeshData.h"
+
+// Compressed vertex streams: 10 bytes per vertex instead of 24, and 16-bit indices when the vertex count allows.
+// Positions are quantized to 16 bits per axis over the mesh bounds, so the error is at most half a step of
+// (max - min) / 65535 per axis. Normals are octahedron-encoded into two 16-bit snorms, about 0.005 degrees apart.
+// Decoding happens per vertex in the vertex stage, see RenderPipeline::_RunVertexProcessing.
+namespace MeshQuantization
+{
+    constexpr float POSITION_STEPS = 65535.0f;
+    constexpr float NORMAL_STEPS = 32767.0f;
+
+    // Decoded position = origin + q * scale
+    inline Vec3 GetPositionScale(const MeshBounds& bounds)
+    {
+        return (bounds.max - bounds.min) * (1.0f / POSITION_STEPS);
+    }
+
+    inline QuantizedPosition EncodePosition(const Vec3& position, const MeshBounds& bounds)
+    {
+        auto encodeAxis = [](float value, float min, float max)
+        {
+            float extent = max - min;
+            float t = extent > 0.0f ? (value - min) / extent : 0.0f;
+            return static_cast<uint16_t>(std::clamp(t, 0.0f, 1.0f) * POSITION_STEPS + 0.5f);
+        };
+        return QuantizedPosition{
+            encodeAxis(position.x, bounds.min.x, bounds.max.x),
+            encodeAxis(position.y, bounds.min.y, bounds.max.y),
+            encodeAxis(position.z, bounds.min.z, bounds.max.z)
+        };
+    }
+
+    inline Vec3 DecodePosition(const QuantizedPosition& position, const Vec3& origin, const Vec3& scale)
+    {
+        return Vec3(
+            origin.x + static_cast<float>(position.x) * scale.x,
+            origin.y + static_cast<float>(position.y) * scale.y,
+            origin.z + static_cast<float>(position.z) * scale.z
+        );
+    }
+
+    // Projects the unit normal onto the octahedron |x| + |y| + |z| = 1 and folds the lower half over the upper
+    inline uint32_t EncodeNormal(const Vec3& normal)
+    {
+        float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (sum <= 0.0f)
+        {
+            return EncodeNormal(Vec3(0.0f, 0.0f, 1.0f));
+        }
+        float u = normal.x / sum;
+        float v = normal.y / sum;
+        if (normal.z < 0.0f)
+        {
+            float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = foldedU;
+            v = foldedV;
+        }
+        auto encodeSnorm = [](float value)
+        {
+            float scaled = std::round(std::clamp(value, -1.0f, 1.0f) * NORMAL_STEPS);
+            return static_cast<uint32_t>(static_cast<uint16_t>(static_cast<int16_t>(scaled)));
+        };
+        return encodeSnorm(u) | (encodeSnorm(v) << 16);
+    }
+
+    inline Vec3 DecodeNormal(uint32_t encoded)
+    {
+        float u = static_cast<float>(static_cast<int16_t>(encoded & 0xFFFFu)) * (1.0f / NORMAL_STEPS);
+        float v = static_cast<float>(static_cast<int16_t>(encoded >> 16)) * (1.0f / NORMAL_STEPS);
+        float z = 1.0f - std::abs(u) - std::abs(v);
+        if (z < 0.0f)
+        {
+            float unfoldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            float unfoldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = unfoldedU;
+            v = unfoldedV;
+        }
+        return Vec3(u, v, z).normalize();
+    }
+
+    // Copies the mesh into quantized streams. UVs and meshlets are kept as they are.
+    // Throws std::runtime_error if the mesh is already quantized.
+    std::shared_ptr<MeshData> Quantize(const MeshData& mesh);
+}
\ No newline at end of file
@@ -4,15 +4,25 @@
  */
 
 #pragma once
+#include "Vec2.h"
 #include "Vec3.h"
 #include "Vec4.h"
+#include <cstdint>
 
 // Read from MeshData, will be sent in to Vertex Shader
 struct VertexInput
 {
     Vec3 positionMS;
     Vec3 normalMS;
-    // TODO: Vec2 uv;
+    Vec2 uv;
+};
+
+// Output of the camera-independent half of the Vertex Shader, see IShader::RunWorldStage
+struct WorldVertex
+{
+    Vec3 positionWS;
+    Vec3 normalWS;
+    Vec2 uv;
 };
 
 // Data need to do interpolation in Rasterization process
@@ -20,7 +30,7 @@ struct Varyings
 {
     Vec3 positionVS;
     Vec3 normalVS;
-    // TODO: Vec2 uv;
+    Vec2 uv;
 };
 
 // The actual output for Vertex Shader.
@@ -37,8 +47,37 @@ struct Fragment
     int y = 0;
     float z_depth = 0.0f;
     Varyings interpolatedVaryings;
+    int shadingSource = -1; // Coarse shading: index of the fragment in this draw whose color is reused, -1 runs the shader
+
+    // Change of interpolatedVaryings.uv per pixel step in x and y, drives the texture mip selection
+    Vec2 uvDdx;
+    Vec2 uvDdy;
+
+    // Multisampling: covered samples, and the screen-space depth slope that gives each sample's depth from z_depth
+    uint32_t coverageMask = 1;
+    float depthDdx = 0.0f;
+    float depthDdy = 0.0f;
+};
+
+// Pixels (width x height) that share one fragment shader invocation, see Material::SetShadingRate
+enum class ShadingRate
+{
+    Rate1x1,
+    Rate1x2,
+    Rate2x2,
+    Rate4x4
 };
 
+inline int GetShadingRateWidth(ShadingRate rate)
+{
+    return rate == ShadingRate::Rate4x4 ? 4 : (rate == ShadingRate::Rate2x2 ? 2 : 1);
+}
+
+inline int GetShadingRateHeight(ShadingRate rate)
+{
+    return rate == ShadingRate::Rate4x4 ? 4 : (rate == ShadingRate::Rate1x1 ? 1 : 2);
+}
+
 // A Triangle composite of 3 VertexOutput
 struct TrianglePrimitive
 {
@@ -54,4 +93,7 @@ struct PixelData
     int y = 0;
     float z_depth = 0.0f;
     Vec3 color;
+    uint32_t coverageMask = 1;
+    float depthDdx = 0.0f;
+    float depthDdy = 0.0f;
 };
\ No newline at end of file
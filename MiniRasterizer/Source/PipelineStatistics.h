@@ -0,0 +1,80 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <cstdint>
+
+// Counters filled in by RenderPipeline while it runs.
+// Available for the last Draw and summed over the current frame (since BeginFrame or ClearBuffers).
+struct PipelineStatistics
+{
+    uint64_t drawCalls = 0;
+    uint64_t vertexCacheHits = 0;
+    uint64_t viewsCulled = 0; // Views of a multi-view draw whose frustum misses the object
+
+    // Geometry
+    uint64_t verticesShaded = 0;
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesCulledInvalidIndex = 0; // Index outside the vertex buffer
+    uint64_t trianglesCulledNearPlane = 0;    // A vertex at or behind the camera (w <= 0.001)
+    uint64_t trianglesCulledOffscreen = 0;    // Bounding box does not overlap the screen
+    uint64_t trianglesCulledDegenerate = 0;   // Zero screen-space area
+    uint64_t trianglesRasterized = 0;
+
+    // Coverage and shading
+    uint64_t boundingBoxPixelsTested = 0;
+    uint64_t fragmentsGenerated = 0;
+    uint64_t fragmentsShaded = 0;             // Fragment shader invocations, fewer than fragments with coarse shading
+    uint64_t depthTestPasses = 0;
+    uint64_t depthTestFailures = 0;
+
+    // Pixels that hold geometry at the end of the frame; only filled in for frame statistics
+    uint64_t pixelsCovered = 0;
+
+    // Wall time per stage in milliseconds
+    double vertexMs = 0.0;
+    double triangleMs = 0.0;
+    double rasterMs = 0.0;
+    double fragmentMs = 0.0;
+    double framebufferMs = 0.0;
+    double totalMs = 0.0;
+
+    // Fragments per covered pixel, 1.0 means every pixel was drawn exactly once
+    float GetOverdrawRatio() const
+    {
+        return pixelsCovered > 0 ? static_cast<float>(fragmentsGenerated) / pixelsCovered : 0.0f;
+    }
+
+    uint64_t GetTrianglesCulled() const
+    {
+        return trianglesCulledInvalidIndex + trianglesCulledNearPlane + trianglesCulledOffscreen + trianglesCulledDegenerate;
+    }
+
+    void Accumulate(const PipelineStatistics& other)
+    {
+        drawCalls += other.drawCalls;
+        vertexCacheHits += other.vertexCacheHits;
+        viewsCulled += other.viewsCulled;
+        verticesShaded += other.verticesShaded;
+        trianglesSubmitted += other.trianglesSubmitted;
+        trianglesCulledInvalidIndex += other.trianglesCulledInvalidIndex;
+        trianglesCulledNearPlane += other.trianglesCulledNearPlane;
+        trianglesCulledOffscreen += other.trianglesCulledOffscreen;
+        trianglesCulledDegenerate += other.trianglesCulledDegenerate;
+        trianglesRasterized += other.trianglesRasterized;
+        boundingBoxPixelsTested += other.boundingBoxPixelsTested;
+        fragmentsGenerated += other.fragmentsGenerated;
+        fragmentsShaded += other.fragmentsShaded;
+        depthTestPasses += other.depthTestPasses;
+        depthTestFailures += other.depthTestFailures;
+        pixelsCovered += other.pixelsCovered;
+        vertexMs += other.vertexMs;
+        triangleMs += other.triangleMs;
+        rasterMs += other.rasterMs;
+        fragmentMs += other.fragmentMs;
+        framebufferMs += other.framebufferMs;
+        totalMs += other.totalMs;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "PostProcess.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace
+{
+    constexpr int BLUR_RADIUS = 4;
+
+    // Binomial weights, sigma of about 1.4 pixels
+    constexpr float BLUR_WEIGHTS[BLUR_RADIUS + 1] = { 70.0f / 256, 56.0f / 256, 28.0f / 256, 8.0f / 256, 1.0f / 256 };
+
+    Vec3 Max0(const Vec3& v)
+    {
+        return Vec3(std::max(v.x, 0.0f), std::max(v.y, 0.0f), std::max(v.z, 0.0f));
+    }
+
+    bool IsDepthEdge(float a, float b, float relativeThreshold)
+    {
+        if (std::isinf(a) || std::isinf(b))
+        {
+            return std::isinf(a) != std::isinf(b);
+        }
+        return std::fabs(a - b) > relativeThreshold * std::min(std::fabs(a), std::fabs(b));
+    }
+}
+
+void PostProcess::ExtractBright(const Vec3* source, int width, int height, float threshold, Vec3* out)
+{
+    const int outWidth = (width + 1) / 2;
+    const int outHeight = (height + 1) / 2;
+    const Vec3 thresholdColor(threshold, threshold, threshold);
+    for (int y = 0; y < outHeight; ++y)
+    {
+        const Vec3* row0 = source + static_cast<size_t>(2 * y) * width;
+        const Vec3* row1 = source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width;
+        for (int x = 0; x < outWidth; ++x)
+        {
+            int x0 = 2 * x;
+            int x1 = std::min(x0 + 1, width - 1);
+            Vec3 average = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+            out[static_cast<size_t>(y) * outWidth + x] = Max0(average - thresholdColor);
+        }
+    }
+}
+
+void PostProcess::BlurHorizontal(const Vec3* source, int width, int height, Vec3* out)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        const Vec3* row = source + static_cast<size_t>(y) * width;
+        Vec3* outRow = out + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            Vec3 sum = row[x] * BLUR_WEIGHTS[0];
+            for (int i = 1; i <= BLUR_RADIUS; ++i)
+            {
+                sum = sum + (row[std::max(x - i, 0)] + row[std::min(x + i, width - 1)]) * BLUR_WEIGHTS[i];
+            }
+            outRow[x] = sum;
+        }
+    }
+}
+
+void PostProcess::BlurVertical(const Vec3* source, int width, int height, Vec3* out)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        Vec3* outRow = out + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            Vec3 sum = source[static_cast<size_t>(y) * width + x] * BLUR_WEIGHTS[0];
+            for (int i = 1; i <= BLUR_RADIUS; ++i)
+            {
+                size_t above = static_cast<size_t>(std::max(y - i, 0)) * width + x;
+                size_t below = static_cast<size_t>(std::min(y + i, height - 1)) * width + x;
+                sum = sum + (source[above] + source[below]) * BLUR_WEIGHTS[i];
+            }
+            outRow[x] = sum;
+        }
+    }
+}
+
+void PostProcess::DetectDepthEdges(const float* depth, int width, int height, float relativeThreshold, float* outEdges)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            size_t index = static_cast<size_t>(y) * width + x;
+            float center = depth[index];
+            bool isEdge = (x + 1 < width && IsDepthEdge(center, depth[index + 1], relativeThreshold)) ||
+                (x > 0 && IsDepthEdge(center, depth[index - 1], relativeThreshold)) ||
+                (y + 1 < height && IsDepthEdge(center, depth[index + width], relativeThreshold)) ||
+                (y > 0 && IsDepthEdge(center, depth[index - width], relativeThreshold));
+            outEdges[index] = isEdge ? 1.0f : 0.0f;
+        }
+    }
+}
+
+void PostProcess::Composite(
+    const Vec3* scene,
+    int width,
+    int height,
+    const Vec3* bloom,
+    int bloomWidth,
+    int bloomHeight,
+    float bloomStrength,
+    const float* edges,
+    Vec3* out)
+{
+    const float scaleX = static_cast<float>(bloomWidth) / width;
+    const float scaleY = static_cast<float>(bloomHeight) / height;
+    for (int y = 0; y < height; ++y)
+    {
+        // Pixel centers of the bloom buffer, clamped to its edges
+        float by = std::max((y + 0.5f) * scaleY - 0.5f, 0.0f);
+        int by0 = std::min(static_cast<int>(by), bloomHeight - 1);
+        int by1 = std::min(by0 + 1, bloomHeight - 1);
+        float fy = by - by0;
+
+        for (int x = 0; x < width; ++x)
+        {
+            size_t index = static_cast<size_t>(y) * width + x;
+            Vec3 color = scene[index];
+            if (bloom)
+            {
+                float bx = std::max((x + 0.5f) * scaleX - 0.5f, 0.0f);
+                int bx0 = std::min(static_cast<int>(bx), bloomWidth - 1);
+                int bx1 = std::min(bx0 + 1, bloomWidth - 1);
+                float fx = bx - bx0;
+                const Vec3* row0 = bloom + static_cast<size_t>(by0) * bloomWidth;
+                const Vec3* row1 = bloom + static_cast<size_t>(by1) * bloomWidth;
+                Vec3 top = row0[bx0] * (1.0f - fx) + row0[bx1] * fx;
+                Vec3 bottom = row1[bx0] * (1.0f - fx) + row1[bx1] * fx;
+                color = color + (top * (1.0f - fy) + bottom * fy) * bloomStrength;
+            }
+            if (edges)
+            {
+                color = color * (1.0f - edges[index]);
+            }
+            out[index] = color;
+        }
+    }
+}
\ No newline at end of file
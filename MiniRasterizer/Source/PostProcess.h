@@ -0,0 +1,36 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include "Vec3.h"
+
+// Screen-space effects over row-major buffers, written to run as render graph passes (see RenderGraph).
+// Every function writes all pixels of its output, and none of them allow the output to alias an input.
+namespace PostProcess
+{
+    // Halves the resolution with a 2x2 box filter and keeps what is above the threshold.
+    // out is (width + 1) / 2 by (height + 1) / 2.
+    void ExtractBright(const Vec3* source, int width, int height, float threshold, Vec3* out);
+
+    // Separable 9-tap Gaussian, edges clamped
+    void BlurHorizontal(const Vec3* source, int width, int height, Vec3* out);
+    void BlurVertical(const Vec3* source, int width, int height, Vec3* out);
+
+    // 1 where the depth jumps by more than the relative threshold to a neighbour or meets the background, else 0
+    void DetectDepthEdges(const float* depth, int width, int height, float relativeThreshold, float* outEdges);
+
+    // out = (scene + bloom * bloomStrength) * (1 - edge). bloom is sampled bilinearly from bloomWidth x bloomHeight;
+    // a null bloom or edges buffer skips that term.
+    void Composite(
+        const Vec3* scene,
+        int width,
+        int height,
+        const Vec3* bloom,
+        int bloomWidth,
+        int bloomHeight,
+        float bloomStrength,
+        const float* edges,
+        Vec3* out);
+}
\ No newline at end of file
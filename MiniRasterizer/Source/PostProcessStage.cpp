@@ -0,0 +1,433 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "PostProcessStage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINIRASTERIZER_SSE2 1
+#include <emmintrin.h>
+#else
+#define MINIRASTERIZER_SSE2 0
+#endif
+
+#include "JobSystem.h"
+#include "Profiler.h"
+
+namespace
+{
+    // Rows per job, smaller bands are not worth scheduling
+    constexpr int BAND_ROWS = 32;
+
+    // Hable's filmic curve
+    constexpr float FILMIC_A = 0.15f; // Shoulder strength
+    constexpr float FILMIC_B = 0.50f; // Linear strength
+    constexpr float FILMIC_C = 0.10f; // Linear angle
+    constexpr float FILMIC_D = 0.20f; // Toe strength
+    constexpr float FILMIC_E = 0.02f; // Toe numerator
+    constexpr float FILMIC_F = 0.30f; // Toe denominator
+    constexpr float FILMIC_WHITE = 11.2f;
+    constexpr float FILMIC_EXPOSURE_BIAS = 2.0f;
+    constexpr float FILMIC_CB = FILMIC_C * FILMIC_B;
+    constexpr float FILMIC_DE = FILMIC_D * FILMIC_E;
+    constexpr float FILMIC_DF = FILMIC_D * FILMIC_F;
+    constexpr float FILMIC_EF = FILMIC_E / FILMIC_F;
+
+    constexpr float HableCurve(float x)
+    {
+        return (x * (FILMIC_A * x + FILMIC_CB) + FILMIC_DE) / (x * (FILMIC_A * x + FILMIC_B) + FILMIC_DF) - FILMIC_EF;
+    }
+    constexpr float FILMIC_WHITE_SCALE = 1.0f / HableCurve(FILMIC_WHITE);
+
+    // ACES fit
+    constexpr float ACES_A = 2.51f;
+    constexpr float ACES_B = 0.03f;
+    constexpr float ACES_C = 2.43f;
+    constexpr float ACES_D = 0.59f;
+    constexpr float ACES_E = 0.14f;
+
+    // sRGB encode: the power curve as a least-squares quintic in sqrt(x)
+    constexpr float SRGB_LINEAR_LIMIT = 0.0031308f;
+    constexpr float SRGB_LINEAR_SLOPE = 12.92f;
+    constexpr float SRGB_P0 = -0.0388820326f;
+    constexpr float SRGB_P1 = 1.4947537241f;
+    constexpr float SRGB_P2 = -1.2742648295f;
+    constexpr float SRGB_P3 = 1.7402083337f;
+    constexpr float SRGB_P4 = -1.3356001321f;
+    constexpr float SRGB_P5 = 0.4141972426f;
+
+    // Rec. 601 luma weights, as FXAA expects
+    constexpr float LUMA_R = 0.299f;
+    constexpr float LUMA_G = 0.587f;
+    constexpr float LUMA_B = 0.114f;
+
+    // FXAA; a pixel is an edge when the luma range around it reaches 1/8 of the brightest neighbour and 1/16 of
+    // full scale (see _ApplyFxaaPixel)
+    constexpr float FXAA_REDUCE_MUL = 1.0f / 8.0f;
+    constexpr float FXAA_REDUCE_MIN = 1.0f / 128.0f;
+    constexpr float FXAA_SPAN_MAX = 8.0f; // Longest blur along the edge, in pixels
+
+    // The scalar and SSE2 versions perform the same operations in the same order, so they round the same way
+    template <Tonemapper TONEMAPPER>
+    float Tonemap(float x)
+    {
+        if constexpr (TONEMAPPER == Tonemapper::Filmic)
+        {
+            return HableCurve(x * FILMIC_EXPOSURE_BIAS) * FILMIC_WHITE_SCALE;
+        }
+        else if constexpr (TONEMAPPER == Tonemapper::ACES)
+        {
+            return (x * (ACES_A * x + ACES_B)) / (x * (ACES_C * x + ACES_D) + ACES_E);
+        }
+        return x;
+    }
+
+    float Saturate(float x)
+    {
+        return std::max(0.0f, std::min(x, 1.0f));
+    }
+
+    // Linear [0, 1] to sRGB without a pow(); within one 8-bit step of the exact curve
+    float EncodeSrgb(float x)
+    {
+        float t = std::sqrt(x);
+        float curve = ((((SRGB_P5 * t + SRGB_P4) * t + SRGB_P3) * t + SRGB_P2) * t + SRGB_P1) * t + SRGB_P0;
+        return x <= SRGB_LINEAR_LIMIT ? x * SRGB_LINEAR_SLOPE : curve;
+    }
+
+#if MINIRASTERIZER_SSE2
+    template <Tonemapper TONEMAPPER>
+    __m128 Tonemap(__m128 x)
+    {
+        if constexpr (TONEMAPPER == Tonemapper::Filmic)
+        {
+            x = _mm_mul_ps(x, _mm_set1_ps(FILMIC_EXPOSURE_BIAS));
+            __m128 ax = _mm_mul_ps(_mm_set1_ps(FILMIC_A), x);
+            __m128 numerator = _mm_add_ps(_mm_mul_ps(x, _mm_add_ps(ax, _mm_set1_ps(FILMIC_CB))), _mm_set1_ps(FILMIC_DE));
+            __m128 denominator = _mm_add_ps(_mm_mul_ps(x, _mm_add_ps(ax, _mm_set1_ps(FILMIC_B))), _mm_set1_ps(FILMIC_DF));
+            __m128 curve = _mm_sub_ps(_mm_div_ps(numerator, denominator), _mm_set1_ps(FILMIC_EF));
+            return _mm_mul_ps(curve, _mm_set1_ps(FILMIC_WHITE_SCALE));
+        }
+        else if constexpr (TONEMAPPER == Tonemapper::ACES)
+        {
+            __m128 numerator = _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ACES_A), x), _mm_set1_ps(ACES_B)));
+            __m128 denominator = _mm_add_ps(
+                _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ACES_C), x), _mm_set1_ps(ACES_D))), _mm_set1_ps(ACES_E));
+            return _mm_div_ps(numerator, denominator);
+        }
+        return x;
+    }
+
+    // min/max return their second operand when either is NaN, so the order maps NaN to 0 like the scalar path
+    __m128 Saturate(__m128 x)
+    {
+        return _mm_max_ps(_mm_min_ps(_mm_set1_ps(1.0f), x), _mm_setzero_ps());
+    }
+
+    __m128 EncodeSrgb(__m128 x)
+    {
+        __m128 t = _mm_sqrt_ps(x);
+        __m128 curve = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SRGB_P5), t), _mm_set1_ps(SRGB_P4));
+        curve = _mm_add_ps(_mm_mul_ps(curve, t), _mm_set1_ps(SRGB_P3));
+        curve = _mm_add_ps(_mm_mul_ps(curve, t), _mm_set1_ps(SRGB_P2));
+        curve = _mm_add_ps(_mm_mul_ps(curve, t), _mm_set1_ps(SRGB_P1));
+        curve = _mm_add_ps(_mm_mul_ps(curve, t), _mm_set1_ps(SRGB_P0));
+        __m128 isLinear = _mm_cmple_ps(x, _mm_set1_ps(SRGB_LINEAR_LIMIT));
+        __m128 linear = _mm_mul_ps(x, _mm_set1_ps(SRGB_LINEAR_SLOPE));
+        return _mm_or_ps(_mm_and_ps(isLinear, linear), _mm_andnot_ps(isLinear, curve));
+    }
+#endif
+
+    // Splits [0, height) into row bands of up to BAND_ROWS rows that run on the job system
+    void ForEachRowBand(int height, const std::function<void(int, int)>& body)
+    {
+        JobSystem::ParallelFor(static_cast<size_t>(height), BAND_ROWS, [&](size_t first, size_t last)
+        {
+            body(static_cast<int>(first), static_cast<int>(last));
+        });
+    }
+
+    uint8_t ComputeLuma(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return static_cast<uint8_t>(static_cast<float>(r) * LUMA_R + static_cast<float>(g) * LUMA_G + static_cast<float>(b) * LUMA_B);
+    }
+
+    // Bilinear tap at pixel-space position (x, y) with pixel centers at +0.5, clamped to the image
+    void SampleBilinear(const uint8_t* image, int width, int height, float x, float y, float out[3])
+    {
+        x = std::min(std::max(x - 0.5f, 0.0f), static_cast<float>(width - 1));
+        y = std::min(std::max(y - 0.5f, 0.0f), static_cast<float>(height - 1));
+        int x0 = static_cast<int>(x);
+        int y0 = static_cast<int>(y);
+        int x1 = std::min(x0 + 1, width - 1);
+        int y1 = std::min(y0 + 1, height - 1);
+        float fx = x - x0;
+        float fy = y - y0;
+
+        const uint8_t* p00 = image + (static_cast<size_t>(y0) * width + x0) * 4;
+        const uint8_t* p10 = image + (static_cast<size_t>(y0) * width + x1) * 4;
+        const uint8_t* p01 = image + (static_cast<size_t>(y1) * width + x0) * 4;
+        const uint8_t* p11 = image + (static_cast<size_t>(y1) * width + x1) * 4;
+        for (int c = 0; c < 3; ++c)
+        {
+            float top = p00[c] + (p10[c] - p00[c]) * fx;
+            float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+            out[c] = top + (bottom - top) * fy;
+        }
+    }
+
+    // Exposes, tonemaps, encodes and quantizes count pixels into RGBA8; with IS_STORING_LUMA the alpha byte holds
+    // the pixel's luma for FXAA. The settings are template parameters so the loop carries no per-pixel branches.
+    template <Tonemapper TONEMAPPER, bool IS_SRGB_ENCODED, bool IS_STORING_LUMA>
+    void EncodePixels(const Vec3* color, size_t count, float exposure, uint8_t* out)
+    {
+        const float quantizeBias = IS_SRGB_ENCODED ? 0.5f : 0.0f; // Linear output truncates like ImageWriter::ConvertToRGB8
+
+        size_t i = 0;
+#if MINIRASTERIZER_SSE2
+        const __m128 exposureVector = _mm_set1_ps(exposure);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128 bias = _mm_set1_ps(quantizeBias);
+        for (; i + 4 <= count; i += 4)
+        {
+            // Four Vec3 are r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3, shuffled into one register per channel
+            const float* source = &color[i].x;
+            __m128 a = _mm_loadu_ps(source);
+            __m128 b = _mm_loadu_ps(source + 4);
+            __m128 c = _mm_loadu_ps(source + 8);
+            __m128 red = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            __m128 green = _mm_shuffle_ps(
+                _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 blue = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+
+            auto quantize = [&](__m128 channel)
+            {
+                __m128 v = Saturate(Tonemap<TONEMAPPER>(_mm_mul_ps(channel, exposureVector)));
+                if constexpr (IS_SRGB_ENCODED)
+                {
+                    v = Saturate(EncodeSrgb(v));
+                }
+                return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), bias));
+            };
+            __m128i r = quantize(red);
+            __m128i g = quantize(green);
+            __m128i bl = quantize(blue);
+
+            __m128i alpha;
+            if constexpr (IS_STORING_LUMA)
+            {
+                __m128 luma = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(_mm_cvtepi32_ps(r), _mm_set1_ps(LUMA_R)),
+                    _mm_mul_ps(_mm_cvtepi32_ps(g), _mm_set1_ps(LUMA_G))),
+                    _mm_mul_ps(_mm_cvtepi32_ps(bl), _mm_set1_ps(LUMA_B)));
+                alpha = _mm_slli_epi32(_mm_cvttps_epi32(luma), 24);
+            }
+            else
+            {
+                alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            }
+
+            // RGBA bytes on a little-endian machine
+            __m128i pixels = _mm_or_si128(
+                _mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                _mm_or_si128(_mm_slli_epi32(bl, 16), alpha));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), pixels);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const float channels[3] = { color[i].x, color[i].y, color[i].z };
+            uint8_t* pixel = out + i * 4;
+            for (int k = 0; k < 3; ++k)
+            {
+                float v = Saturate(Tonemap<TONEMAPPER>(channels[k] * exposure));
+                if constexpr (IS_SRGB_ENCODED)
+                {
+                    v = Saturate(EncodeSrgb(v));
+                }
+                pixel[k] = static_cast<uint8_t>(v * 255.0f + quantizeBias);
+            }
+            pixel[3] = IS_STORING_LUMA ? ComputeLuma(pixel[0], pixel[1], pixel[2]) : 255;
+        }
+    }
+
+    using EncodeFunction = void (*)(const Vec3* color, size_t count, float exposure, uint8_t* out);
+
+    template <Tonemapper TONEMAPPER>
+    EncodeFunction SelectEncoder(bool isSrgbEncoded, bool isStoringLuma)
+    {
+        if (isSrgbEncoded)
+        {
+            return isStoringLuma ? &EncodePixels<TONEMAPPER, true, true> : &EncodePixels<TONEMAPPER, true, false>;
+        }
+        return isStoringLuma ? &EncodePixels<TONEMAPPER, false, true> : &EncodePixels<TONEMAPPER, false, false>;
+    }
+
+    EncodeFunction SelectEncoder(const PostProcessSettings& settings, bool isStoringLuma)
+    {
+        switch (settings.tonemapper)
+        {
+        case Tonemapper::Filmic:
+            return SelectEncoder<Tonemapper::Filmic>(settings.isSrgbEncoded, isStoringLuma);
+        case Tonemapper::ACES:
+            return SelectEncoder<Tonemapper::ACES>(settings.isSrgbEncoded, isStoringLuma);
+        default:
+            return SelectEncoder<Tonemapper::Clamp>(settings.isSrgbEncoded, isStoringLuma);
+        }
+    }
+}
+
+void PostProcessStage::Run(const Vec3* color, int width, int height, uint8_t* outRGBA)
+{
+    PROFILE_SCOPE("PostProcess");
+    auto start = std::chrono::steady_clock::now();
+
+    const float exposure = _settings.exposure;
+    if (!_settings.isFxaaEnabled)
+    {
+        EncodeFunction encode = SelectEncoder(_settings, false);
+        ForEachRowBand(height, [&](int y0, int y1)
+        {
+            size_t first = static_cast<size_t>(y0) * width;
+            encode(color + first, static_cast<size_t>(y1 - y0) * width, exposure, outRGBA + first * 4);
+        });
+    }
+    else
+    {
+        // FXAA reads neighbouring rows, so every band is encoded before any is smoothed
+        EncodeFunction encode = SelectEncoder(_settings, true);
+        _encoded.resize(static_cast<size_t>(width) * height * 4);
+        ForEachRowBand(height, [&](int y0, int y1)
+        {
+            size_t first = static_cast<size_t>(y0) * width;
+            encode(color + first, static_cast<size_t>(y1 - y0) * width, exposure, _encoded.data() + first * 4);
+        });
+        ForEachRowBand(height, [&](int y0, int y1)
+        {
+            _ApplyFxaa(_encoded.data(), width, height, y0, y1, outRGBA);
+        });
+    }
+
+    _lastMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Scans the band for edges: four pixels per SSE2 step in the interior, where no neighbour needs clamping
+void PostProcessStage::_ApplyFxaa(const uint8_t* in, int width, int height, int y0, int y1, uint8_t* out) const
+{
+    for (int y = y0; y < y1; ++y)
+    {
+        int x = 0;
+#if MINIRASTERIZER_SSE2
+        if (y > 0 && y + 1 < height)
+        {
+            const uint8_t* row = in + static_cast<size_t>(y) * width * 4;
+            const uint8_t* rowN = row - static_cast<size_t>(width) * 4;
+            const uint8_t* rowS = row + static_cast<size_t>(width) * 4;
+            uint8_t* outRow = out + static_cast<size_t>(y) * width * 4;
+            const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i darkLimit = _mm_set1_epi32(255);
+
+            _ApplyFxaaPixel(in, width, height, 0, y, out);
+            for (x = 1; x + 5 <= width; x += 4)
+            {
+                __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4));
+                __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + (x - 1) * 4));
+                __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + (x + 1) * 4));
+                __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowN + x * 4));
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowS + x * 4));
+                __m128i lumaMin = _mm_srli_epi32(_mm_min_epu8(m, _mm_min_epu8(_mm_min_epu8(n, s), _mm_min_epu8(w, e))), 24);
+                __m128i lumaMax = _mm_srli_epi32(_mm_max_epu8(m, _mm_max_epu8(_mm_max_epu8(n, s), _mm_max_epu8(w, e))), 24);
+                __m128i range = _mm_sub_epi32(lumaMax, lumaMin);
+                __m128i isFlat = _mm_or_si128(
+                    _mm_cmplt_epi32(_mm_slli_epi32(range, 4), darkLimit),
+                    _mm_cmplt_epi32(_mm_slli_epi32(range, 3), lumaMax));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(outRow + x * 4), _mm_or_si128(m, opaque));
+                int flatMask = _mm_movemask_ps(_mm_castsi128_ps(isFlat));
+                for (int k = 0; k < 4; ++k)
+                {
+                    if (!(flatMask & (1 << k)))
+                    {
+                        _ApplyFxaaPixel(in, width, height, x + k, y, out);
+                    }
+                }
+            }
+        }
+#endif
+        for (; x < width; ++x)
+        {
+            _ApplyFxaaPixel(in, width, height, x, y, out);
+        }
+    }
+}
+
+// The console variant of FXAA 3.11: the edge direction comes from the diagonal lumas, and two or four bilinear taps
+// along it are blended, falling back to the inner two when the outer ones pick up a different surface
+void PostProcessStage::_ApplyFxaaPixel(const uint8_t* in, int width, int height, int x, int y, uint8_t* out) const
+{
+    auto luma = [&](int sx, int sy)
+    {
+        sx = std::min(std::max(sx, 0), width - 1);
+        sy = std::min(std::max(sy, 0), height - 1);
+        return static_cast<int>(in[(static_cast<size_t>(sy) * width + sx) * 4 + 3]);
+    };
+
+    size_t index = (static_cast<size_t>(y) * width + x) * 4;
+    std::memcpy(out + index, in + index, 3);
+    out[index + 3] = 255;
+
+    // Same test as the SSE2 scan in integer lumas: range < max(255 / 16, lumaMax / 8)
+    int lumaM = in[index + 3];
+    int lumaN = luma(x, y - 1);
+    int lumaS = luma(x, y + 1);
+    int lumaW = luma(x - 1, y);
+    int lumaE = luma(x + 1, y);
+    int lumaMin = std::min(lumaM, std::min(std::min(lumaN, lumaS), std::min(lumaW, lumaE)));
+    int lumaMax = std::max(lumaM, std::max(std::max(lumaN, lumaS), std::max(lumaW, lumaE)));
+    int range = lumaMax - lumaMin;
+    if (range * 16 < 255 || range * 8 < lumaMax)
+    {
+        return;
+    }
+
+    const float toUnit = 1.0f / 255.0f;
+    float lumaNW = luma(x - 1, y - 1) * toUnit;
+    float lumaNE = luma(x + 1, y - 1) * toUnit;
+    float lumaSW = luma(x - 1, y + 1) * toUnit;
+    float lumaSE = luma(x + 1, y + 1) * toUnit;
+    float dirX = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    float dirY = (lumaNW + lumaSW) - (lumaNE + lumaSE);
+    float dirReduce = std::max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25f * FXAA_REDUCE_MUL, FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0f / (std::min(std::fabs(dirX), std::fabs(dirY)) + dirReduce);
+    dirX = std::min(std::max(dirX * rcpDirMin, -FXAA_SPAN_MAX), FXAA_SPAN_MAX);
+    dirY = std::min(std::max(dirY * rcpDirMin, -FXAA_SPAN_MAX), FXAA_SPAN_MAX);
+
+    const float centerX = x + 0.5f;
+    const float centerY = y + 0.5f;
+    float inner0[3], inner1[3], outer0[3], outer1[3];
+    SampleBilinear(in, width, height, centerX + dirX * (1.0f / 3.0f - 0.5f), centerY + dirY * (1.0f / 3.0f - 0.5f), inner0);
+    SampleBilinear(in, width, height, centerX + dirX * (2.0f / 3.0f - 0.5f), centerY + dirY * (2.0f / 3.0f - 0.5f), inner1);
+    SampleBilinear(in, width, height, centerX - dirX * 0.5f, centerY - dirY * 0.5f, outer0);
+    SampleBilinear(in, width, height, centerX + dirX * 0.5f, centerY + dirY * 0.5f, outer1);
+
+    float colorA[3], colorB[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        colorA[c] = 0.5f * (inner0[c] + inner1[c]);
+        colorB[c] = colorA[c] * 0.5f + 0.25f * (outer0[c] + outer1[c]);
+    }
+    float lumaB = colorB[0] * LUMA_R + colorB[1] * LUMA_G + colorB[2] * LUMA_B;
+    const float* result = (lumaB < lumaMin || lumaB > lumaMax) ? colorA : colorB;
+    for (int c = 0; c < 3; ++c)
+    {
+        out[index + c] = static_cast<uint8_t>(result[c] + 0.5f);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Vec3.h"
+
+enum class Tonemapper
+{
+    Clamp,  // Clip every channel to [0, 1]
+    Filmic, // Hable's curve with a soft shoulder, white point at 11.2
+    ACES    // Narkowicz's fit of the ACES reference transform
+};
+
+struct PostProcessSettings
+{
+    Tonemapper tonemapper = Tonemapper::Clamp;
+    float exposure = 1.0f;      // Applied before tonemapping
+    bool isSrgbEncoded = false; // Off writes the tonemapped linear value
+    bool isFxaaEnabled = false;
+
+    bool operator==(const PostProcessSettings& other) const
+    {
+        return tonemapper == other.tonemapper && exposure == other.exposure &&
+               isSrgbEncoded == other.isSrgbEncoded && isFxaaEnabled == other.isFxaaEnabled;
+    }
+
+    bool operator!=(const PostProcessSettings& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Turns the linear HDR color buffer into displayable RGBA8 pixels.
+//
+// The first pass is fused: every pixel is read once, exposed, tonemapped, encoded and quantized, four pixels per
+// SSE2 step. With FXAA on it also stores the pixel's luma in the alpha byte, and a second pass smooths the edges it
+// finds from those lumas and writes alpha 255. Both passes are split into row bands that run on the job system.
+// The default settings reproduce ImageWriter::ConvertToRGB8 exactly.
+class PostProcessStage
+{
+public:
+    void SetSettings(const PostProcessSettings& settings) { _settings = settings; }
+    const PostProcessSettings& GetSettings() const { return _settings; }
+
+    // color is width * height row-major, outRGBA receives width * height * 4 bytes
+    void Run(const Vec3* color, int width, int height, uint8_t* outRGBA);
+
+    double GetLastMs() const { return _lastMs; }
+
+private:
+    void _ApplyFxaa(const uint8_t* in, int width, int height, int y0, int y1, uint8_t* out) const;
+    void _ApplyFxaaPixel(const uint8_t* in, int width, int height, int x, int y, uint8_t* out) const;
+
+    PostProcessSettings _settings;
+    std::vector<uint8_t> _encoded; // FXAA input
+    double _lastMs = 0.0;
+};
\ No newline at end of file
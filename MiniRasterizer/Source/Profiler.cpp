@@ -0,0 +1,182 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "Profiler.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // A ring buffer slot. The fields are relaxed atomics because WriteChromeTrace may copy a slot while the
+    // producer overwrites it; such a copy is detected afterwards and dropped.
+    struct TraceSlot
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> startNs{ 0 };
+        std::atomic<uint64_t> endNs{ 0 };
+    };
+
+    // Single producer (the owning thread), read by WriteChromeTrace.
+    // The producer fills a slot and then publishes it by advancing writeCount with release ordering.
+    struct ThreadEventBuffer
+    {
+        std::vector<TraceSlot> events = std::vector<TraceSlot>(Profiler::EVENTS_PER_THREAD);
+        std::atomic<uint64_t> writeCount{ 0 };
+        std::atomic<uint64_t> clearedCount{ 0 };
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    // Buffers live until the process exits, so a dump never reads a buffer of a thread that has finished
+    std::mutex g_registryMutex;
+    std::vector<std::unique_ptr<ThreadEventBuffer>> g_buffers;
+
+    ThreadEventBuffer& GetThreadBuffer()
+    {
+        thread_local ThreadEventBuffer* buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            g_buffers.push_back(std::make_unique<ThreadEventBuffer>());
+            buffer = g_buffers.back().get();
+            buffer->threadId = static_cast<uint32_t>(g_buffers.size());
+        }
+        return *buffer;
+    }
+
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    void WriteJsonString(std::ofstream& file, const std::string& text)
+    {
+        file << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                file << '\\';
+            }
+            file << c;
+        }
+        file << '"';
+    }
+}
+
+std::atomic<bool> Profiler::g_isEnabled{ false };
+
+void Profiler::SetEnabled(bool isEnabled)
+{
+    g_isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    ThreadEventBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    buffer.threadName = name;
+}
+
+uint64_t Profiler::Now()
+{
+    // +1 keeps 0 free to mean "not recording" in ProfileScope
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count()) + 1;
+}
+
+void Profiler::RecordEvent(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadEventBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.writeCount.load(std::memory_order_relaxed);
+    TraceSlot& slot = buffer.events[index % EVENTS_PER_THREAD];
+    // Pairs with the reader's acquire fence: a reader that sees any of the stores below also sees writeCount at index
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.endNs.store(endNs, std::memory_order_relaxed);
+    buffer.writeCount.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::WriteChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Profiler: Cannot open '" + path + "' for writing.");
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool isFirst = true;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (const auto& buffer : g_buffers)
+    {
+        // Snapshot the published range, then copy it out
+        uint64_t end = buffer->writeCount.load(std::memory_order_acquire);
+        uint64_t begin = std::max(buffer->clearedCount.load(std::memory_order_relaxed),
+            end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0);
+
+        std::vector<TraceEvent> events;
+        events.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const TraceSlot& slot = buffer->events[i % EVENTS_PER_THREAD];
+            events.push_back(TraceEvent{
+                slot.name.load(std::memory_order_relaxed),
+                slot.startNs.load(std::memory_order_relaxed),
+                slot.endNs.load(std::memory_order_relaxed) });
+        }
+
+        // Slots the producer may have overwritten while we were copying are dropped. If the copy saw any store of
+        // the RecordEvent for index k, the fence pair makes endAfterCopy at least k, so that slot is dropped too.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t endAfterCopy = buffer->writeCount.load(std::memory_order_relaxed);
+        uint64_t firstIntact = endAfterCopy + 1 > EVENTS_PER_THREAD ? endAfterCopy + 1 - EVENTS_PER_THREAD : 0;
+        size_t skipCount = firstIntact > begin ? static_cast<size_t>(std::min(firstIntact - begin, end - begin)) : 0;
+
+        if (!buffer->threadName.empty())
+        {
+            file << (isFirst ? "" : ",\n");
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+            WriteJsonString(file, buffer->threadName);
+            file << "}}";
+            isFirst = false;
+        }
+
+        for (size_t i = skipCount; i < events.size(); ++i)
+        {
+            const TraceEvent& event = events[i];
+            file << (isFirst ? "" : ",\n");
+            file << "{\"name\":";
+            WriteJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNs / 1000.0
+                << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0 << "}";
+            isFirst = false;
+        }
+    }
+
+    file << "\n]}\n";
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (const auto& buffer : g_buffers)
+    {
+        buffer->clearedCount.store(buffer->writeCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timing markers written as Chrome trace events (chrome://tracing, Perfetto).
+//
+// Each thread records into its own fixed-size ring buffer, so recording never takes a lock; when the ring
+// wraps, the oldest events are overwritten. Recording is off by default and toggled at runtime with
+// SetEnabled(); a disabled PROFILE_SCOPE costs one relaxed atomic load. Build with
+// MINIRASTERIZER_PROFILER=0 to compile the markers out entirely.
+#ifndef MINIRASTERIZER_PROFILER
+#define MINIRASTERIZER_PROFILER 1
+#endif
+
+namespace Profiler
+{
+    // Events kept per thread before the oldest are overwritten
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+    extern std::atomic<bool> g_isEnabled;
+
+    inline bool IsEnabled()
+    {
+        return g_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool isEnabled);
+
+    // Shown as the thread's name in the trace viewer
+    void SetThreadName(const std::string& name);
+
+    // Nanoseconds on a monotonic clock
+    uint64_t Now();
+
+    // name must outlive the trace (string literals)
+    void RecordEvent(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // Writes every event still held in the ring buffers; throws std::runtime_error if the file cannot be written
+    void WriteChromeTrace(const std::string& path);
+
+    // Drops all recorded events
+    void Clear();
+}
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+        : _name(name),
+        _startNs(Profiler::IsEnabled() ? Profiler::Now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (_startNs != 0)
+        {
+            Profiler::RecordEvent(_name, _startNs, Profiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* _name;
+    uint64_t _startNs;
+};
+
+#if MINIRASTERIZER_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,392 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "RenderGraph.h"
+#include <algorithm>
+#include <stdexcept>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Color targets are stored as floats");
+
+Vec3* RenderPassContext::GetColor(RenderTargetHandle target) const
+{
+    if (GetDesc(target).format != RenderTargetFormat::Color)
+    {
+        throw std::runtime_error("RenderGraph: Target '" + _graph._targets[target].name + "' is not a color target.");
+    }
+    return static_cast<Vec3*>(_graph._GetMemory(target));
+}
+
+float* RenderPassContext::GetDepth(RenderTargetHandle target) const
+{
+    if (GetDesc(target).format != RenderTargetFormat::Depth)
+    {
+        throw std::runtime_error("RenderGraph: Target '" + _graph._targets[target].name + "' is not a depth target.");
+    }
+    return static_cast<float*>(_graph._GetMemory(target));
+}
+
+const RenderTargetDesc& RenderPassContext::GetDesc(RenderTargetHandle target) const
+{
+    _graph._CheckTarget(target);
+    return _graph._targets[target].desc;
+}
+
+RenderTargetHandle RenderGraph::CreateTarget(const std::string& name, const RenderTargetDesc& desc)
+{
+    return _AddTarget(name, desc, nullptr);
+}
+
+RenderTargetHandle RenderGraph::ImportColor(const std::string& name, std::vector<Vec3>& buffer, int width, int height)
+{
+    if (buffer.size() < static_cast<size_t>(width) * height)
+    {
+        throw std::runtime_error("RenderGraph: Imported target '" + name + "' is smaller than its size.");
+    }
+    return _AddTarget(name, { width, height, RenderTargetFormat::Color }, buffer.data());
+}
+
+RenderTargetHandle RenderGraph::ImportDepth(const std::string& name, std::vector<float>& buffer, int width, int height)
+{
+    if (buffer.size() < static_cast<size_t>(width) * height)
+    {
+        throw std::runtime_error("RenderGraph: Imported target '" + name + "' is smaller than its size.");
+    }
+    return _AddTarget(name, { width, height, RenderTargetFormat::Depth }, buffer.data());
+}
+
+RenderTargetHandle RenderGraph::_AddTarget(const std::string& name, const RenderTargetDesc& desc, void* importedMemory)
+{
+    if (desc.width <= 0 || desc.height <= 0)
+    {
+        throw std::runtime_error("RenderGraph: Target '" + name + "' must have a positive size.");
+    }
+    Target target;
+    target.name = name;
+    target.desc = desc;
+    target.importedMemory = importedMemory;
+    _targets.push_back(target);
+    _isCompiled = false;
+    return static_cast<RenderTargetHandle>(_targets.size() - 1);
+}
+
+void RenderGraph::AddPass(
+    const std::string& name,
+    const std::vector<RenderTargetHandle>& reads,
+    const std::vector<RenderTargetHandle>& writes,
+    ExecuteFunction execute)
+{
+    for (RenderTargetHandle target : reads)
+    {
+        _CheckTarget(target);
+    }
+    for (RenderTargetHandle target : writes)
+    {
+        _CheckTarget(target);
+    }
+    Pass pass;
+    pass.name = name;
+    pass.reads = reads;
+    pass.writes = writes;
+    pass.execute = std::move(execute);
+    _passes.push_back(std::move(pass));
+    _isCompiled = false;
+}
+
+void RenderGraph::_CheckTarget(RenderTargetHandle target) const
+{
+    if (target >= _targets.size())
+    {
+        throw std::runtime_error("RenderGraph: Unknown target handle.");
+    }
+}
+
+void RenderGraph::Compile()
+{
+    _stats = RenderGraphStats();
+    _stats.passCount = _passes.size();
+
+    _FindDependencies();
+    _CullPasses();
+    _AssignLevels();
+    _AliasTargets();
+    _isCompiled = true;
+}
+
+void RenderGraph::_FindDependencies()
+{
+    const size_t noWriter = _passes.size();
+    std::vector<size_t> lastWriter(_targets.size(), noWriter);
+    std::vector<std::vector<size_t>> readersSinceWrite(_targets.size());
+
+    for (size_t i = 0; i < _passes.size(); ++i)
+    {
+        Pass& pass = _passes[i];
+        pass.producers.clear();
+        pass.dependencies.clear();
+
+        // Read after write
+        for (RenderTargetHandle target : pass.reads)
+        {
+            if (lastWriter[target] != noWriter)
+            {
+                pass.producers.push_back(lastWriter[target]);
+            }
+            else if (!_targets[target].importedMemory)
+            {
+                throw std::runtime_error("RenderGraph: Pass '" + pass.name + "' reads target '" +
+                    _targets[target].name + "' before any pass writes it.");
+            }
+        }
+
+        // Write after write and write after read
+        pass.dependencies = pass.producers;
+        for (RenderTargetHandle target : pass.writes)
+        {
+            if (lastWriter[target] != noWriter)
+            {
+                pass.dependencies.push_back(lastWriter[target]);
+            }
+            pass.dependencies.insert(pass.dependencies.end(),
+                readersSinceWrite[target].begin(), readersSinceWrite[target].end());
+        }
+        std::sort(pass.dependencies.begin(), pass.dependencies.end());
+        pass.dependencies.erase(std::unique(pass.dependencies.begin(), pass.dependencies.end()), pass.dependencies.end());
+
+        for (RenderTargetHandle target : pass.reads)
+        {
+            readersSinceWrite[target].push_back(i);
+        }
+        for (RenderTargetHandle target : pass.writes)
+        {
+            lastWriter[target] = i;
+            readersSinceWrite[target].clear();
+        }
+    }
+}
+
+void RenderGraph::_CullPasses()
+{
+    for (Pass& pass : _passes)
+    {
+        pass.isKept = std::any_of(pass.writes.begin(), pass.writes.end(),
+            [this](RenderTargetHandle target) { return _targets[target].importedMemory != nullptr; });
+    }
+    // Walking backwards, a kept pass keeps the passes it reads from; those always come earlier
+    for (size_t i = _passes.size(); i-- > 0;)
+    {
+        if (!_passes[i].isKept)
+        {
+            ++_stats.passesCulled;
+            continue;
+        }
+        for (size_t producer : _passes[i].producers)
+        {
+            _passes[producer].isKept = true;
+        }
+    }
+}
+
+void RenderGraph::_AssignLevels()
+{
+    _levels.clear();
+    for (size_t i = 0; i < _passes.size(); ++i)
+    {
+        Pass& pass = _passes[i];
+        pass.level = -1;
+        if (!pass.isKept)
+        {
+            continue;
+        }
+
+        // Dependencies come earlier in declaration order, so their levels are already known
+        int level = 0;
+        for (size_t dependency : pass.dependencies)
+        {
+            if (_passes[dependency].isKept)
+            {
+                level = std::max(level, _passes[dependency].level + 1);
+            }
+        }
+        pass.level = level;
+        if (static_cast<size_t>(level) >= _levels.size())
+        {
+            _levels.resize(level + 1);
+        }
+        _levels[level].push_back(i);
+    }
+    _stats.levelCount = _levels.size();
+}
+
+void RenderGraph::_AliasTargets()
+{
+    for (Target& target : _targets)
+    {
+        target.block = -1;
+        target.firstLevel = -1;
+        target.lastLevel = -1;
+    }
+    for (const Pass& pass : _passes)
+    {
+        if (!pass.isKept)
+        {
+            continue;
+        }
+        auto extend = [&](RenderTargetHandle handle)
+        {
+            Target& target = _targets[handle];
+            target.firstLevel = target.firstLevel < 0 ? pass.level : std::min(target.firstLevel, pass.level);
+            target.lastLevel = std::max(target.lastLevel, pass.level);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), extend);
+        std::for_each(pass.writes.begin(), pass.writes.end(), extend);
+    }
+
+    std::vector<size_t> transients;
+    for (size_t i = 0; i < _targets.size(); ++i)
+    {
+        if (!_targets[i].importedMemory && _targets[i].firstLevel >= 0)
+        {
+            transients.push_back(i);
+            _stats.transientBytes += _targets[i].desc.GetByteSize();
+        }
+    }
+    std::sort(transients.begin(), transients.end(), [this](size_t a, size_t b)
+    {
+        if (_targets[a].firstLevel != _targets[b].firstLevel)
+        {
+            return _targets[a].firstLevel < _targets[b].firstLevel;
+        }
+        return _targets[a].desc.GetByteSize() > _targets[b].desc.GetByteSize();
+    });
+
+    // A block is free once the last level of its current target is over. Take the smallest free block that fits,
+    // else grow the largest free one, else add a block.
+    std::vector<int> blockLastLevel(_blocks.size(), -1);
+    std::vector<size_t> blockFloats(_blocks.size());
+    std::vector<uint8_t> isBlockUsed(_blocks.size(), 0);
+    for (size_t b = 0; b < _blocks.size(); ++b)
+    {
+        blockFloats[b] = _blocks[b].size();
+    }
+    for (size_t i : transients)
+    {
+        Target& target = _targets[i];
+        size_t floatCount = target.desc.GetByteSize() / sizeof(float);
+
+        int bestFit = -1;
+        int largest = -1;
+        for (size_t b = 0; b < blockFloats.size(); ++b)
+        {
+            if (blockLastLevel[b] >= target.firstLevel)
+            {
+                continue;
+            }
+            if (blockFloats[b] >= floatCount && (bestFit < 0 || blockFloats[b] < blockFloats[bestFit]))
+            {
+                bestFit = static_cast<int>(b);
+            }
+            if (largest < 0 || blockFloats[b] > blockFloats[largest])
+            {
+                largest = static_cast<int>(b);
+            }
+        }
+
+        int block = bestFit >= 0 ? bestFit : largest;
+        if (block < 0)
+        {
+            block = static_cast<int>(blockFloats.size());
+            blockLastLevel.push_back(-1);
+            blockFloats.push_back(0);
+            isBlockUsed.push_back(0);
+        }
+        target.block = block;
+        blockLastLevel[block] = target.lastLevel;
+        blockFloats[block] = std::max(blockFloats[block], floatCount);
+        isBlockUsed[block] = 1;
+    }
+
+    _blocks.resize(blockFloats.size());
+    for (size_t b = 0; b < _blocks.size(); ++b)
+    {
+        _blocks[b].resize(blockFloats[b]);
+        if (isBlockUsed[b])
+        {
+            _stats.allocatedBytes += blockFloats[b] * sizeof(float);
+        }
+    }
+}
+
+void* RenderGraph::_GetMemory(RenderTargetHandle target) const
+{
+    _CheckTarget(target);
+    const Target& t = _targets[target];
+    if (t.importedMemory)
+    {
+        return t.importedMemory;
+    }
+    if (t.block < 0)
+    {
+        throw std::runtime_error("RenderGraph: Target '" + t.name + "' is not used by any kept pass.");
+    }
+    return const_cast<float*>(_blocks[t.block].data());
+}
+
+void RenderGraph::_RunPass(const Pass& pass) const
+{
+    ProfileScope scope(pass.name.c_str());
+    pass.execute(RenderPassContext(*this));
+}
+
+void RenderGraph::Execute()
+{
+    if (!_isCompiled)
+    {
+        throw std::runtime_error("RenderGraph: Execute() needs Compile() after the graph changed.");
+    }
+
+    for (const std::vector<size_t>& level : _levels)
+    {
+        if (level.size() == 1)
+        {
+            _RunPass(_passes[level[0]]);
+            continue;
+        }
+
+        // One job per pass; a pass that runs parallel stages of its own shares the same workers
+        JobSystem::ParallelFor(level.size(), 1, [this, &level](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                _RunPass(_passes[level[i]]);
+            }
+        });
+    }
+}
+
+void RenderGraph::Reset()
+{
+    _targets.clear();
+    _passes.clear();
+    _levels.clear();
+    _isCompiled = false;
+    _stats = RenderGraphStats();
+}
+
+std::vector<std::vector<std::string>> RenderGraph::GetSchedule() const
+{
+    std::vector<std::vector<std::string>> schedule;
+    for (const std::vector<size_t>& level : _levels)
+    {
+        schedule.emplace_back();
+        for (size_t i : level)
+        {
+            schedule.back().push_back(_passes[i].name);
+        }
+    }
+    return schedule;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "Vec3.h"
+
+enum class RenderTargetFormat
+{
+    Color, // One Vec3 per pixel
+    Depth  // One float per pixel
+};
+
+struct RenderTargetDesc
+{
+    int width = 0;
+    int height = 0;
+    RenderTargetFormat format = RenderTargetFormat::Color;
+
+    size_t GetByteSize() const
+    {
+        size_t pixelBytes = format == RenderTargetFormat::Color ? sizeof(Vec3) : sizeof(float);
+        return static_cast<size_t>(width) * height * pixelBytes;
+    }
+};
+
+using RenderTargetHandle = uint32_t;
+
+// What a pass sees while it runs: the row-major memory of the targets it declared
+class RenderPassContext
+{
+public:
+    Vec3* GetColor(RenderTargetHandle target) const;
+    float* GetDepth(RenderTargetHandle target) const;
+    const RenderTargetDesc& GetDesc(RenderTargetHandle target) const;
+
+private:
+    friend class RenderGraph;
+    explicit RenderPassContext(const class RenderGraph& graph) : _graph(graph) {}
+
+    const class RenderGraph& _graph;
+};
+
+struct RenderGraphStats
+{
+    size_t passCount = 0;
+    size_t passesCulled = 0;
+    size_t levelCount = 0;    // Batches of independent passes, run one after another
+    size_t transientBytes = 0; // Sum of the transient targets that are used
+    size_t allocatedBytes = 0; // What they take after aliasing
+};
+
+// A frame as a list of passes that declare which targets they read and write.
+//
+// Compile() works out the schedule from those declarations alone:
+//   culling   only passes that (transitively) feed an imported target are kept
+//   ordering  a pass depends on the last earlier writer of everything it reads (read after write), and a write
+//             also waits for the earlier readers and writer of that target (write after read/write); passes
+//             are grouped into levels, each level depending only on earlier ones
+//   aliasing  a transient target lives from the first to the last level that uses it, and targets whose
+//             lifetimes do not overlap share one block of memory
+// Execute() then runs the levels in order, the passes of one level side by side on the job system.
+//
+// Passes are declared in execution order: a pass may only read a transient target that an earlier pass writes.
+// Transient memory is not cleared, so a pass that writes a target must write every pixel of it. Imported targets
+// are owned by the caller, keep their contents between frames and are the graph's outputs. Passes of one level
+// run concurrently, so they must not share any other mutable state. A compiled graph can be executed any number
+// of times; the memory blocks are kept across Compile() calls and only grow.
+class RenderGraph
+{
+public:
+    using ExecuteFunction = std::function<void(const RenderPassContext&)>;
+
+    RenderTargetHandle CreateTarget(const std::string& name, const RenderTargetDesc& desc);
+
+    // The buffers must outlive the graph and hold width * height pixels
+    RenderTargetHandle ImportColor(const std::string& name, std::vector<Vec3>& buffer, int width, int height);
+    RenderTargetHandle ImportDepth(const std::string& name, std::vector<float>& buffer, int width, int height);
+
+    // The pass name also labels the pass in the profiler
+    void AddPass(
+        const std::string& name,
+        const std::vector<RenderTargetHandle>& reads,
+        const std::vector<RenderTargetHandle>& writes,
+        ExecuteFunction execute);
+
+    // Throws std::runtime_error when a pass reads a transient target nothing has written yet
+    void Compile();
+
+    // Throws std::runtime_error when the graph changed since Compile(); rethrows the first exception of a pass
+    void Execute();
+
+    // Drops every pass and target, keeping the memory blocks for the next graph
+    void Reset();
+
+    // Kept pass names per level, valid after Compile()
+    std::vector<std::vector<std::string>> GetSchedule() const;
+    const RenderGraphStats& GetStats() const { return _stats; }
+
+private:
+    friend class RenderPassContext;
+
+    struct Target
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        void* importedMemory = nullptr; // Null for a transient target
+        int block = -1;                 // Memory block of a transient target, -1 while unused
+        int firstLevel = -1;
+        int lastLevel = -1;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::vector<RenderTargetHandle> reads;
+        std::vector<RenderTargetHandle> writes;
+        ExecuteFunction execute;
+        std::vector<size_t> producers;    // Last earlier writers of the reads
+        std::vector<size_t> dependencies; // Producers plus the write-after-read/write hazards
+        bool isKept = false;
+        int level = -1;
+    };
+
+    RenderTargetHandle _AddTarget(const std::string& name, const RenderTargetDesc& desc, void* importedMemory);
+    void _CheckTarget(RenderTargetHandle target) const;
+    void _FindDependencies();
+    void _CullPasses();
+    void _AssignLevels();
+    void _AliasTargets();
+    void* _GetMemory(RenderTargetHandle target) const;
+    void _RunPass(const Pass& pass) const;
+
+    std::vector<Target> _targets;
+    std::vector<Pass> _passes;
+    std::vector<std::vector<size_t>> _levels; // Kept pass indices per level
+    std::vector<std::vector<float>> _blocks;
+    bool _isCompiled = false;
+    RenderGraphStats _stats;
+};
\ No newline at end of file
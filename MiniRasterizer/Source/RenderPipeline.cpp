@@ -10,71 +10,757 @@
 #include <algorithm>
 #include <limits>
 #include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <atomic>
+#include "FrameHash.h"
+#include "JobSystem.h"
+#include "MeshQuantization.h"
+#include "Profiler.h"
+#include "ShaderUtils.h"
+
+namespace
+{
+    using StageClock = std::chrono::steady_clock;
+
+    double ElapsedMs(StageClock::time_point start, StageClock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Scales are kept on a coarse grid so the controller does not resize the buffers for tiny changes
+    constexpr float RENDER_SCALE_STEP = 0.05f;
+
+    // Dead band around the target, inside it the scale is left alone
+    constexpr double FRAME_TIME_OVER_TARGET = 1.05;
+    constexpr double FRAME_TIME_UNDER_TARGET = 0.8;
+
+    // Cap on how far the scale may rise in one frame; it may drop as far as needed at once
+    constexpr float MAX_RENDER_SCALE_INCREASE = 0.1f;
+
+    // Items per job of the parallel stages, large enough that splitting costs little next to the shader calls
+    constexpr size_t VERTEX_GRAIN_SIZE = 1024;
+    constexpr size_t FRAGMENT_GRAIN_SIZE = 512;
+    constexpr size_t FRAMEBUFFER_GRAIN_SIZE = 2048;
+
+    // Standard 4x rotated-grid sample positions, relative to the pixel center
+    constexpr float MSAA_SAMPLE_OFFSETS[FrameBuffer::MAX_SAMPLE_COUNT][2] = {
+        { -0.125f, -0.375f },
+        { 0.375f, -0.125f },
+        { -0.375f, 0.125f },
+        { 0.125f, 0.375f }
+    };
+
+    // Triangle assembly for either index width; triangles with an out-of-range index are dropped
+    template <typename Index>
+    void AssembleTriangles(
+        const ArenaVector<VertexOutput>& vertexOutputs,
+        ArrayView<Index> indices,
+        ArenaVector<TrianglePrimitive>& outTriangles)
+    {
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            size_t i0 = indices[i];
+            size_t i1 = indices[i + 1];
+            size_t i2 = indices[i + 2];
+
+            if (i0 >= vertexOutputs.size() ||
+                i1 >= vertexOutputs.size() ||
+                i2 >= vertexOutputs.size())
+            {
+                continue;
+            }
+
+            outTriangles.push_back(TrianglePrimitive{ vertexOutputs[i0], vertexOutputs[i1], vertexOutputs[i2] });
+        }
+    }
+
+    // Reads vertex i of a mesh into the vertex shader input, decoding quantized streams
+    class VertexFetcher
+    {
+    public:
+        explicit VertexFetcher(const MeshData& mesh)
+            : _streams(mesh.GetStreams()),
+            _isQuantized(mesh.IsQuantized()),
+            _hasUVs(!mesh.GetStreams().uvs.empty()),
+            _positionOrigin(mesh.GetBounds().min),
+            _positionScale(MeshQuantization::GetPositionScale(mesh.GetBounds()))
+        {
+        }
+
+        VertexInput Fetch(size_t i) const
+        {
+            VertexInput vertexInput;
+            if (_isQuantized)
+            {
+                vertexInput.positionMS = MeshQuantization::DecodePosition(
+                    _streams.quantizedPositions[i], _positionOrigin, _positionScale);
+                vertexInput.normalMS = MeshQuantization::DecodeNormal(_streams.octahedralNormals[i]);
+            }
+            else
+            {
+                vertexInput.positionMS = _streams.positions[i];
+                vertexInput.normalMS = _streams.normals[i];
+            }
+            if (_hasUVs)
+            {
+                vertexInput.uv = _streams.uvs[i];
+            }
+            return vertexInput;
+        }
+
+    private:
+        const MeshStreams& _streams;
+        bool _isQuantized;
+        bool _hasUVs;
+        Vec3 _positionOrigin;
+        Vec3 _positionScale;
+    };
+
+    // True when all eight corners of the box lie outside one clip plane of the camera
+    bool IsOutsideFrustum(const MeshBounds& bounds, const Camera& camera)
+    {
+        int outsideCounts[6] = {};
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            Vec3 positionWS(
+                (corner & 1) ? bounds.max.x : bounds.min.x,
+                (corner & 2) ? bounds.max.y : bounds.min.y,
+                (corner & 4) ? bounds.max.z : bounds.min.z);
+            Vec4 clip = ShaderUtils::TransformViewToClip(ShaderUtils::TransformWorldToView(positionWS, camera), camera);
+            outsideCounts[0] += clip.x < -clip.w;
+            outsideCounts[1] += clip.x > clip.w;
+            outsideCounts[2] += clip.y < -clip.w;
+            outsideCounts[3] += clip.y > clip.w;
+            outsideCounts[4] += clip.z < -clip.w;
+            outsideCounts[5] += clip.z > clip.w;
+        }
+        return std::any_of(std::begin(outsideCounts), std::end(outsideCounts), [](int count) { return count == 8; });
+    }
+}
 
 RenderPipeline::RenderPipeline(int width, int height)
     : _width(width),
-    _height(height)
+    _height(height),
+    _renderWidth(width),
+    _renderHeight(height),
+    _viewport{ 0, 0, width, height },
+    _scissor{ 0, 0, width, height },
+    _imageWindow{ 0, 0, width, height },
+    _frameBuffer(width, height),
+    _worldVertexCache(_frameArena),
+    _vertexOutputCache(_frameArena),
+    _triangleCache(_frameArena),
+    _fragmentCache(_frameArena),
+    _pixelCache(_frameArena)
 {
-    _InitializeDepthBuffer();
-    _InitializeColorBuffer();
 }
 
 void RenderPipeline::SetCamera(const Camera& camera)
 {
-    _camera = camera;
+    if (camera != _camera)
+    {
+        _camera = camera;
+        _cameraVersion = NextStateVersion();
+    }
 }
 
 void RenderPipeline::SetLight(const Light& light)
 {
-    _light = light;
+    if (light != _light)
+    {
+        _light = light;
+        _lightVersion = NextStateVersion();
+    }
+}
+
+bool RenderPipeline::BeginFrame(uint64_t sceneKey)
+{
+    FrameHash frameHash;
+    frameHash.Add(sceneKey);
+    frameHash.Add(_cameraVersion);
+    frameHash.Add(_lightVersion);
+    frameHash.Add(_settingsVersion);
+    uint64_t frameKey = frameHash.GetValue();
+
+    if (_hasCompletedFrame && frameKey == _completedFrameKey)
+    {
+        return false;
+    }
+
+    ClearBuffers();
+    _currentFrameKey = frameKey;
+    _isInsideFrame = true;
+    _frameStartTime = StageClock::now();
+    return true;
+}
+
+void RenderPipeline::EndFrame()
+{
+    if (!_isInsideFrame)
+    {
+        throw std::runtime_error("EndFrame called without a matching BeginFrame.");
+    }
+    _isInsideFrame = false;
+    _completedFrameKey = _currentFrameKey;
+    _hasCompletedFrame = true;
+
+    _lastFrameMs = ElapsedMs(_frameStartTime, StageClock::now());
+    if (_targetFrameMs > 0.0)
+    {
+        _UpdateRenderScale(_lastFrameMs);
+    }
+}
+
+void RenderPipeline::SetRenderScale(float scale)
+{
+    scale = std::min(1.0f, std::max(scale, 1.0f / std::max(_width, _height)));
+    if (scale != _pendingRenderScale)
+    {
+        _pendingRenderScale = scale;
+        _settingsVersion = NextStateVersion();
+    }
+}
+
+void RenderPipeline::SetImageWindow(int imageWidth, int imageHeight, int x, int y)
+{
+    if (imageWidth <= 0 || imageHeight <= 0)
+    {
+        throw std::runtime_error("SetImageWindow: Image size must be positive.");
+    }
+    Viewport imageWindow{ -x, -y, imageWidth, imageHeight };
+    if (imageWindow.x != _imageWindow.x || imageWindow.y != _imageWindow.y ||
+        imageWindow.width != _imageWindow.width || imageWindow.height != _imageWindow.height)
+    {
+        _imageWindow = imageWindow;
+        _settingsVersion = NextStateVersion();
+    }
+}
+
+void RenderPipeline::SetTargetFrameTime(double targetMs, float minScale)
+{
+    _targetFrameMs = targetMs;
+    _minRenderScale = std::min(1.0f, std::max(minScale, RENDER_SCALE_STEP));
+}
+
+void RenderPipeline::_UpdateRenderScale(double frameMs)
+{
+    if (frameMs <= 0.0 ||
+        (frameMs <= _targetFrameMs * FRAME_TIME_OVER_TARGET && frameMs >= _targetFrameMs * FRAME_TIME_UNDER_TARGET))
+    {
+        return;
+    }
+
+    // Raster and fragment cost follow the pixel count, which goes with the square of the scale
+    float desired = _renderScale * static_cast<float>(std::sqrt(_targetFrameMs / frameMs));
+    desired = std::min(desired, _renderScale + MAX_RENDER_SCALE_INCREASE);
+    desired = std::floor(desired / RENDER_SCALE_STEP + 0.5f) * RENDER_SCALE_STEP;
+    desired = std::min(1.0f, std::max(desired, _minRenderScale));
+    SetRenderScale(desired);
+}
+
+void RenderPipeline::_ApplyRenderScale()
+{
+    _renderScale = _pendingRenderScale;
+    _renderWidth = std::max(1, static_cast<int>(std::lround(_width * _renderScale)));
+    _renderHeight = std::max(1, static_cast<int>(std::lround(_height * _renderScale)));
+    _scissor = Viewport{ 0, 0, _renderWidth, _renderHeight };
+    if (_imageWindow.x == 0 && _imageWindow.y == 0 && _imageWindow.width == _width && _imageWindow.height == _height)
+    {
+        _viewport = _scissor;
+    }
+    else
+    {
+        _viewport = Viewport{
+            static_cast<int>(std::lround(_imageWindow.x * _renderScale)),
+            static_cast<int>(std::lround(_imageWindow.y * _renderScale)),
+            std::max(1, static_cast<int>(std::lround(_imageWindow.width * _renderScale))),
+            std::max(1, static_cast<int>(std::lround(_imageWindow.height * _renderScale))) };
+    }
+    if (_renderWidth == _frameBuffer.GetWidth() && _renderHeight == _frameBuffer.GetHeight())
+    {
+        return;
+    }
+    _frameBuffer.Resize(_renderWidth, _renderHeight);
+
+    // Pixel centers of the output mapped into the render target, clamped at the edges
+    _upscaleColumns.resize(_width);
+    _upscaleColumnWeights.resize(_width);
+    float ratioX = static_cast<float>(_renderWidth) / _width;
+    for (int x = 0; x < _width; ++x)
+    {
+        float sourceX = std::max(0.0f, (x + 0.5f) * ratioX - 0.5f);
+        int x0 = std::min(static_cast<int>(sourceX), _renderWidth - 1);
+        _upscaleColumns[x] = x0;
+        _upscaleColumnWeights[x] = (x0 + 1 < _renderWidth) ? sourceX - x0 : 0.0f;
+    }
+    if (_upscaledColor.empty())
+    {
+        _upscaledColor.resize(static_cast<size_t>(_width) * _height);
+    }
+}
+
+void RenderPipeline::_UpscaleColor(const std::vector<Vec3>& source) const
+{
+    PROFILE_SCOPE("Upscale");
+    float ratioY = static_cast<float>(_renderHeight) / _height;
+    for (int y = 0; y < _height; ++y)
+    {
+        float sourceY = std::max(0.0f, (y + 0.5f) * ratioY - 0.5f);
+        int y0 = std::min(static_cast<int>(sourceY), _renderHeight - 1);
+        int y1 = std::min(y0 + 1, _renderHeight - 1);
+        float fy = sourceY - y0;
+
+        const Vec3* row0 = &source[static_cast<size_t>(y0) * _renderWidth];
+        const Vec3* row1 = &source[static_cast<size_t>(y1) * _renderWidth];
+        Vec3* outRow = &_upscaledColor[static_cast<size_t>(y) * _width];
+        for (int x = 0; x < _width; ++x)
+        {
+            int x0 = _upscaleColumns[x];
+            int x1 = std::min(x0 + 1, _renderWidth - 1);
+            float fx = _upscaleColumnWeights[x];
+
+            Vec3 top = row0[x0] * (1.0f - fx) + row0[x1] * fx;
+            Vec3 bottom = row1[x0] * (1.0f - fx) + row1[x1] * fx;
+            outRow[x] = top * (1.0f - fy) + bottom * fy;
+        }
+    }
 }
 
 void RenderPipeline::ClearBuffers()
 {
-    std::fill(_depthBuffer.begin(), _depthBuffer.end(), std::numeric_limits<float>::infinity());
-    std::fill(_colorBuffer.begin(), _colorBuffer.end(), Vec3(0, 0, 0));
+    PROFILE_SCOPE("ClearBuffers");
+    _ApplyRenderScale();
+    _isUpscaleDirty = true;
+    _frameBuffer.Clear(std::numeric_limits<float>::infinity(), Vec3(0, 0, 0));
+    _frameArena.Reset();
+    _hasCompletedFrame = false;
+    _frameStatistics = PipelineStatistics();
+}
+
+PipelineStatistics RenderPipeline::GetFrameStatistics() const
+{
+    PipelineStatistics statistics = _frameStatistics;
+    statistics.pixelsCovered = _frameBuffer.CountCoveredPixels();
+    return statistics;
 }
 
 void RenderPipeline::Draw(const MeshData& mesh, const Vec3& objectPosition)
 {
+    PROFILE_SCOPE("Draw");
     if (!_boundShader || !_boundProperties)
     {
         throw std::runtime_error("Draw call failed: Shader or Properties not bound.");
     }
 
-    _vertexOutputCache.clear();
-    _RunVertexProcessing(
-        mesh.GetPositions(),
-        mesh.GetNormals(),
-        objectPosition,
-        _vertexOutputCache
-    );
+    if (!_isInsideFrame)
+    {
+        // Drawing on top of a completed frame changes it, so it can no longer be reused
+        _hasCompletedFrame = false;
+    }
 
-    _triangleCache.clear();
-    _RunTriangleProcessing(
-        _vertexOutputCache,
-        mesh.GetIndices(),
-        _triangleCache
-    );
+    _drawStatistics = PipelineStatistics();
+    _drawStatistics.drawCalls = 1;
+    StageClock::time_point drawStart = StageClock::now();
+
+    // A NaN position never equals itself, so its key could never be found or evicted
+    bool isCacheable = _vertexCache.IsEnabled() &&
+        !std::isnan(objectPosition.x) && !std::isnan(objectPosition.y) && !std::isnan(objectPosition.z);
+    VertexCacheKey vertexCacheKey;
+    const std::vector<TrianglePrimitive>* cachedTriangles = nullptr;
+    if (isCacheable)
+    {
+        vertexCacheKey.meshVersion = mesh.GetVersion();
+        vertexCacheKey.objectPosition = objectPosition;
+        vertexCacheKey.cameraVersion = _cameraVersion;
+        vertexCacheKey.shader = _boundShader;
+        cachedTriangles = _vertexCache.Find(vertexCacheKey);
+    }
+
+    StageClock::time_point vertexEnd = drawStart;
+    StageClock::time_point triangleEnd = drawStart;
+    const TrianglePrimitive* triangles = nullptr;
+    size_t triangleCount = 0;
+    if (cachedTriangles)
+    {
+        _drawStatistics.vertexCacheHits = 1;
+        triangles = cachedTriangles->data();
+        triangleCount = cachedTriangles->size();
+    }
+    else
+    {
+        _vertexOutputCache.clear();
+        _RunVertexProcessing(
+            mesh,
+            objectPosition,
+            _vertexOutputCache
+        );
+        _drawStatistics.verticesShaded = _vertexOutputCache.size();
+        vertexEnd = StageClock::now();
+
+        _triangleCache.clear();
+        _RunTriangleProcessing(
+            _vertexOutputCache,
+            mesh,
+            _triangleCache
+        );
+
+        if (isCacheable)
+        {
+            _vertexCache.Insert(vertexCacheKey, _triangleCache.data(), _triangleCache.size());
+        }
+        triangles = _triangleCache.data();
+        triangleCount = _triangleCache.size();
+        triangleEnd = StageClock::now();
+    }
+    _drawStatistics.trianglesSubmitted = mesh.GetIndexCount() / 3;
+    _drawStatistics.trianglesCulledInvalidIndex = _drawStatistics.trianglesSubmitted - triangleCount;
 
     _fragmentCache.clear();
     _RunRasterization(
-        _triangleCache,
+        triangles,
+        triangleCount,
         _fragmentCache
     );
+    // Give the growth slack back before the fragment stage allocates behind it
+    _fragmentCache.shrink_to_fit();
+    _drawStatistics.fragmentsGenerated = _fragmentCache.size();
+    StageClock::time_point rasterEnd = StageClock::now();
 
     _pixelCache.clear();
     _RunFragmentProcessing(
         _fragmentCache,
         _pixelCache
     );
+    StageClock::time_point fragmentEnd = StageClock::now();
 
     _RunFramebufferOperations(_pixelCache);
+    StageClock::time_point drawEnd = StageClock::now();
+
+    _drawStatistics.vertexMs = ElapsedMs(drawStart, vertexEnd);
+    _drawStatistics.triangleMs = ElapsedMs(vertexEnd, triangleEnd);
+    _drawStatistics.rasterMs = ElapsedMs(triangleEnd, rasterEnd);
+    _drawStatistics.fragmentMs = ElapsedMs(rasterEnd, fragmentEnd);
+    _drawStatistics.framebufferMs = ElapsedMs(fragmentEnd, drawEnd);
+    _drawStatistics.totalMs = ElapsedMs(drawStart, drawEnd);
+    _frameStatistics.Accumulate(_drawStatistics);
+}
+
+void RenderPipeline::DrawMultiView(const MeshData& mesh, const Vec3& objectPosition, const std::vector<RenderView>& views)
+{
+    PROFILE_SCOPE("DrawMultiView");
+    if (!_boundShader || !_boundProperties)
+    {
+        throw std::runtime_error("Draw call failed: Shader or Properties not bound.");
+    }
+
+    if (!_isInsideFrame)
+    {
+        _hasCompletedFrame = false;
+    }
+
+    _drawStatistics = PipelineStatistics();
+    _drawStatistics.drawCalls = 1;
+    StageClock::time_point drawStart = StageClock::now();
+
+    // Shared by every view
+    _worldVertexCache.clear();
+    _RunWorldProcessing(mesh, objectPosition, _worldVertexCache);
+    const MeshBounds worldBounds{ mesh.GetBounds().min + objectPosition, mesh.GetBounds().max + objectPosition };
+    _drawStatistics.vertexMs = ElapsedMs(drawStart, StageClock::now());
+
+    // The views borrow the pipeline camera, viewport and scissor, which are put back even if a stage throws
+    const Camera pipelineCamera = _camera;
+    const Viewport fullViewport = _viewport;
+    const Viewport fullScissor = _scissor;
+    try
+    {
+        for (const RenderView& view : views)
+        {
+            Viewport viewport = _ScaleViewport(view);
+            if (viewport.width <= 0 || viewport.height <= 0 || IsOutsideFrustum(worldBounds, view.camera))
+            {
+                _drawStatistics.viewsCulled++;
+                continue;
+            }
+            _camera = view.camera;
+            _viewport = viewport;
+            _scissor = viewport;
+
+            StageClock::time_point viewStart = StageClock::now();
+            _vertexOutputCache.clear();
+            _RunViewProcessing(_worldVertexCache, _vertexOutputCache);
+            _drawStatistics.verticesShaded += _vertexOutputCache.size();
+            StageClock::time_point vertexEnd = StageClock::now();
+
+            _triangleCache.clear();
+            _RunTriangleProcessing(_vertexOutputCache, mesh, _triangleCache);
+            uint64_t trianglesSubmitted = mesh.GetIndexCount() / 3;
+            _drawStatistics.trianglesSubmitted += trianglesSubmitted;
+            _drawStatistics.trianglesCulledInvalidIndex += trianglesSubmitted - _triangleCache.size();
+            StageClock::time_point triangleEnd = StageClock::now();
+
+            _fragmentCache.clear();
+            _RunRasterization(_triangleCache.data(), _triangleCache.size(), _fragmentCache);
+            _fragmentCache.shrink_to_fit();
+            _drawStatistics.fragmentsGenerated += _fragmentCache.size();
+            StageClock::time_point rasterEnd = StageClock::now();
+
+            _pixelCache.clear();
+            _RunFragmentProcessing(_fragmentCache, _pixelCache);
+            StageClock::time_point fragmentEnd = StageClock::now();
+
+            _RunFramebufferOperations(_pixelCache);
+            StageClock::time_point viewEnd = StageClock::now();
+
+            _drawStatistics.vertexMs += ElapsedMs(viewStart, vertexEnd);
+            _drawStatistics.triangleMs += ElapsedMs(vertexEnd, triangleEnd);
+            _drawStatistics.rasterMs += ElapsedMs(triangleEnd, rasterEnd);
+            _drawStatistics.fragmentMs += ElapsedMs(rasterEnd, fragmentEnd);
+            _drawStatistics.framebufferMs += ElapsedMs(fragmentEnd, viewEnd);
+        }
+    }
+    catch (...)
+    {
+        _camera = pipelineCamera;
+        _viewport = fullViewport;
+        _scissor = fullScissor;
+        throw;
+    }
+    _camera = pipelineCamera;
+    _viewport = fullViewport;
+    _scissor = fullScissor;
+
+    _drawStatistics.totalMs = ElapsedMs(drawStart, StageClock::now());
+    _frameStatistics.Accumulate(_drawStatistics);
+}
+
+std::vector<Vec3> RenderPipeline::RenderMaterialAtlas(
+    const MeshData& mesh,
+    const Vec3& objectPosition,
+    const std::vector<const Material*>& materials,
+    int cellWidth,
+    int cellHeight,
+    int columns)
+{
+    PROFILE_SCOPE("RenderMaterialAtlas");
+    if (cellWidth <= 0 || cellHeight <= 0 || columns <= 0)
+    {
+        throw std::runtime_error("RenderMaterialAtlas: Cell size and column count must be positive.");
+    }
+    for (const Material* material : materials)
+    {
+        if (!material || !material->GetShader() || !material->GetProperties())
+        {
+            throw std::runtime_error("RenderMaterialAtlas: Every material needs a shader and properties.");
+        }
+    }
+
+    const int rows = static_cast<int>((materials.size() + columns - 1) / columns);
+    const int atlasWidth = columns * cellWidth;
+    std::vector<Vec3> atlas(static_cast<size_t>(atlasWidth) * rows * cellHeight, Vec3(0, 0, 0));
+    _drawStatistics = PipelineStatistics();
+    _drawStatistics.drawCalls = 1;
+    StageClock::time_point atlasStart = StageClock::now();
+
+    // Vertex shading may differ between shaders, so each shader gets its own visibility pass
+    std::vector<std::pair<const IShader*, std::vector<Fragment>>> visibleByShader;
+
+    // The geometry passes borrow the bound shader, shading rate, viewport and scissor, which are put back even on
+    // a throw
+    const IShader* boundShader = _boundShader;
+    const ShadingRate boundShadingRate = _boundShadingRate;
+    const Viewport fullViewport = _viewport;
+    const Viewport fullScissor = _scissor;
+    try
+    {
+        for (size_t i = 0; i < materials.size(); ++i)
+        {
+            const IShader* shader = materials[i]->GetShader();
+            auto visible = std::find_if(visibleByShader.begin(), visibleByShader.end(),
+                [shader](const auto& entry) { return entry.first == shader; });
+            if (visible == visibleByShader.end())
+            {
+                _BindShader(shader);
+                _boundShadingRate = ShadingRate::Rate1x1;
+                _viewport = Viewport{ 0, 0, cellWidth, cellHeight };
+                _scissor = _viewport;
+                visibleByShader.emplace_back(shader, std::vector<Fragment>());
+                visible = visibleByShader.end() - 1;
+                _ResolveVisibleFragments(mesh, objectPosition, visible->second);
+            }
+
+            const IShaderProperties& properties = *materials[i]->GetProperties();
+            const int cellX = static_cast<int>(i % columns) * cellWidth;
+            const int cellY = static_cast<int>(i / columns) * cellHeight;
+            const std::vector<Fragment>& fragments = visible->second;
+            JobSystem::ParallelFor(fragments.size(), FRAGMENT_GRAIN_SIZE, [&](size_t first, size_t last)
+            {
+                for (size_t f = first; f < last; ++f)
+                {
+                    const Fragment& fragment = fragments[f];
+                    atlas[static_cast<size_t>(cellY + fragment.y) * atlasWidth + cellX + fragment.x] =
+                        shader->RunFragmentShader(fragment, _camera, _light, properties);
+                }
+            });
+            _drawStatistics.fragmentsShaded += visible->second.size();
+        }
+    }
+    catch (...)
+    {
+        _BindShader(boundShader);
+        _boundShadingRate = boundShadingRate;
+        _viewport = fullViewport;
+        _scissor = fullScissor;
+        throw;
+    }
+    _BindShader(boundShader);
+    _boundShadingRate = boundShadingRate;
+    _viewport = fullViewport;
+    _scissor = fullScissor;
+    _drawStatistics.totalMs = ElapsedMs(atlasStart, StageClock::now());
+    return atlas;
+}
+
+void RenderPipeline::_ResolveVisibleFragments(
+    const MeshData& mesh,
+    const Vec3& objectPosition,
+    std::vector<Fragment>& outFragments
+)
+{
+    _vertexOutputCache.clear();
+    _RunVertexProcessing(mesh, objectPosition, _vertexOutputCache);
+    _drawStatistics.verticesShaded += _vertexOutputCache.size();
+
+    _triangleCache.clear();
+    _RunTriangleProcessing(_vertexOutputCache, mesh, _triangleCache);
+    _drawStatistics.trianglesSubmitted += mesh.GetIndexCount() / 3;
+
+    _fragmentCache.clear();
+    _RunRasterization(_triangleCache.data(), _triangleCache.size(), _fragmentCache);
+    _drawStatistics.fragmentsGenerated += _fragmentCache.size();
+
+    // Same outcome as the depth test: the nearest fragment wins, ties go to the one drawn first
+    std::vector<int> nearest(static_cast<size_t>(_viewport.width) * _viewport.height, -1);
+    for (size_t i = 0; i < _fragmentCache.size(); ++i)
+    {
+        const Fragment& fragment = _fragmentCache[i];
+        int& winner = nearest[static_cast<size_t>(fragment.y - _viewport.y) * _viewport.width + fragment.x - _viewport.x];
+        if (winner < 0 || fragment.z_depth < _fragmentCache[winner].z_depth)
+        {
+            winner = static_cast<int>(i);
+        }
+    }
+
+    outFragments.clear();
+    for (int winner : nearest)
+    {
+        if (winner >= 0)
+        {
+            outFragments.push_back(_fragmentCache[winner]);
+        }
+    }
+}
+
+RenderPipeline::Viewport RenderPipeline::_ScaleViewport(const RenderView& view) const
+{
+    // Edges are scaled rather than the size, so adjacent viewports stay adjacent at any render scale
+    int x0 = std::clamp(static_cast<int>(std::lround(view.x * _renderScale)), 0, _renderWidth);
+    int y0 = std::clamp(static_cast<int>(std::lround(view.y * _renderScale)), 0, _renderHeight);
+    int x1 = std::clamp(static_cast<int>(std::lround((view.x + view.width) * _renderScale)), 0, _renderWidth);
+    int y1 = std::clamp(static_cast<int>(std::lround((view.y + view.height) * _renderScale)), 0, _renderHeight);
+    return Viewport{ x0, y0, x1 - x0, y1 - y0 };
 }
 
 const std::vector<Vec3>& RenderPipeline::GetFinalColorBuffer() const
 {
-    return _colorBuffer;
+    const std::vector<Vec3>& color = _frameBuffer.ResolveColor();
+    if (_renderWidth == _width && _renderHeight == _height)
+    {
+        return color;
+    }
+
+    if (_isUpscaleDirty)
+    {
+        _UpscaleColor(color);
+        _isUpscaleDirty = false;
+    }
+    return _upscaledColor;
+}
+
+void RenderPipeline::CopyFinalDepthBuffer(float* out) const
+{
+    if (_renderWidth == _width && _renderHeight == _height)
+    {
+        _frameBuffer.ResolveDepth(out);
+        return;
+    }
+
+    _resolvedDepth.resize(static_cast<size_t>(_renderWidth) * _renderHeight);
+    _frameBuffer.ResolveDepth(_resolvedDepth.data());
+    for (int y = 0; y < _height; ++y)
+    {
+        const float* sourceRow = &_resolvedDepth[static_cast<size_t>(y * _renderHeight / _height) * _renderWidth];
+        float* outRow = out + static_cast<size_t>(y) * _width;
+        for (int x = 0; x < _width; ++x)
+        {
+            outRow[x] = sourceRow[x * _renderWidth / _width];
+        }
+    }
+}
+
+void RenderPipeline::SetPostProcess(const PostProcessSettings& settings)
+{
+    if (settings != _postProcess.GetSettings())
+    {
+        _postProcess.SetSettings(settings);
+        _settingsVersion = NextStateVersion();
+    }
+}
+
+void RenderPipeline::ResolveDisplayPixels(std::vector<uint8_t>& outRGBA)
+{
+    ApplyPostProcess(GetFinalColorBuffer(), _width, _height, outRGBA);
+}
+
+void RenderPipeline::ApplyPostProcess(const std::vector<Vec3>& color, int width, int height, std::vector<uint8_t>& outRGBA)
+{
+    if (color.size() != static_cast<size_t>(width) * height)
+    {
+        throw std::runtime_error("RenderPipeline: Post-process input does not match its size.");
+    }
+    outRGBA.resize(color.size() * 4);
+    _postProcess.Run(color.data(), width, height, outRGBA.data());
+}
+
+void RenderPipeline::SetSampleCount(int sampleCount)
+{
+    if (sampleCount != _frameBuffer.GetSampleCount())
+    {
+        _frameBuffer.SetSampleCount(sampleCount);
+        _isUpscaleDirty = true;
+        _settingsVersion = NextStateVersion();
+    }
+}
+
+void RenderPipeline::SetBufferLayout(BufferLayout layout)
+{
+    if (layout != _frameBuffer.GetLayout())
+    {
+        _frameBuffer.SetLayout(layout);
+        _settingsVersion = NextStateVersion();
+    }
+}
+
+void RenderPipeline::SetPixelStorage(PixelStorage storage)
+{
+    if (storage != _frameBuffer.GetPixelStorage())
+    {
+        _frameBuffer.SetPixelStorage(storage);
+        _isUpscaleDirty = true;
+        _settingsVersion = NextStateVersion();
+    }
 }
 
 void RenderPipeline::BindMaterial(Material* material)
@@ -83,11 +769,13 @@ void RenderPipeline::BindMaterial(Material* material)
     {
         _BindShader(material->GetShader());
         _BindProperties(material->GetProperties());
+        _boundShadingRate = material->GetShadingRate();
     }
     else
     {
         _BindShader(nullptr);
         _BindProperties(nullptr);
+        _boundShadingRate = ShadingRate::Rate1x1;
     }
 }
 
@@ -101,81 +789,108 @@ void RenderPipeline::_BindProperties(IShaderProperties* properties)
     _boundProperties = properties;
 }
 
-void RenderPipeline::_InitializeDepthBuffer()
-{
-    _depthBuffer.resize(_width * _height, std::numeric_limits<float>::infinity());
-}
-
-void RenderPipeline::_InitializeColorBuffer()
-{
-    _colorBuffer.resize(_width * _height, Vec3(0, 0, 0));
-}
-
 // Pipeline Stages
 void RenderPipeline::_RunVertexProcessing(
-    const std::vector<Vec3>& positions,
-    const std::vector<Vec3>& normals,
+    const MeshData& mesh,
     const Vec3& objectPosition,
-    std::vector<VertexOutput>& outVertexOutputs
+    ArenaVector<VertexOutput>& outVertexOutputs
 ) const
 {
-    outVertexOutputs.reserve(positions.size());
+    PROFILE_SCOPE("VertexProcessing");
+    const size_t vertexCount = mesh.GetVertexCount();
+    const size_t firstOutput = outVertexOutputs.size();
+    outVertexOutputs.resize(firstOutput + vertexCount);
+    VertexOutput* vertexOutputs = outVertexOutputs.data() + firstOutput;
+    const VertexFetcher fetcher(mesh);
 
-    for (size_t i = 0; i < positions.size(); ++i)
+    // Every vertex writes its own slot, so the output order does not depend on how the jobs were split
+    JobSystem::ParallelFor(vertexCount, VERTEX_GRAIN_SIZE, [&](size_t first, size_t last)
     {
-        VertexInput vertexInput;
-        vertexInput.positionMS = positions[i];
-        vertexInput.normalMS = normals[i];
+        for (size_t i = first; i < last; ++i)
+        {
+            vertexOutputs[i] = _boundShader->RunVertexShader(
+                fetcher.Fetch(i),
+                _camera,
+                objectPosition
+            );
+        }
+    });
+}
 
-        VertexOutput vertexOutput = _boundShader->RunVertexShader(
-            vertexInput,
-            _camera,
-            objectPosition
-        );
+void RenderPipeline::_RunWorldProcessing(
+    const MeshData& mesh,
+    const Vec3& objectPosition,
+    ArenaVector<WorldVertex>& outWorldVertices
+) const
+{
+    PROFILE_SCOPE("WorldProcessing");
+    const size_t vertexCount = mesh.GetVertexCount();
+    const size_t firstOutput = outWorldVertices.size();
+    outWorldVertices.resize(firstOutput + vertexCount);
+    WorldVertex* worldVertices = outWorldVertices.data() + firstOutput;
+    const VertexFetcher fetcher(mesh);
 
-        outVertexOutputs.push_back(vertexOutput);
-    }
+    JobSystem::ParallelFor(vertexCount, VERTEX_GRAIN_SIZE, [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            worldVertices[i] = _boundShader->RunWorldStage(fetcher.Fetch(i), objectPosition);
+        }
+    });
 }
 
-void RenderPipeline::_RunTriangleProcessing(
-    const std::vector<VertexOutput>& vertexOutputs,
-    const std::vector<unsigned int>& indices,
-    std::vector<TrianglePrimitive>& outTriangles
+void RenderPipeline::_RunViewProcessing(
+    const ArenaVector<WorldVertex>& worldVertices,
+    ArenaVector<VertexOutput>& outVertexOutputs
 ) const
 {
-    outTriangles.reserve(indices.size() / 3);
+    PROFILE_SCOPE("ViewProcessing");
+    const size_t firstOutput = outVertexOutputs.size();
+    outVertexOutputs.resize(firstOutput + worldVertices.size());
+    VertexOutput* vertexOutputs = outVertexOutputs.data() + firstOutput;
 
-    for (size_t i = 0; i < indices.size(); i += 3)
+    JobSystem::ParallelFor(worldVertices.size(), VERTEX_GRAIN_SIZE, [&](size_t first, size_t last)
     {
-        unsigned int i0 = indices[i];
-        unsigned int i1 = indices[i + 1];
-        unsigned int i2 = indices[i + 2];
-
-        if (i0 >= vertexOutputs.size() ||
-            i1 >= vertexOutputs.size() ||
-            i2 >= vertexOutputs.size())
+        for (size_t i = first; i < last; ++i)
         {
-            continue;
+            vertexOutputs[i] = _boundShader->RunViewStage(worldVertices[i], _camera);
         }
+    });
+}
 
-        const VertexOutput& v0 = vertexOutputs[i0];
-        const VertexOutput& v1 = vertexOutputs[i1];
-        const VertexOutput& v2 = vertexOutputs[i2];
+void RenderPipeline::_RunTriangleProcessing(
+    const ArenaVector<VertexOutput>& vertexOutputs,
+    const MeshData& mesh,
+    ArenaVector<TrianglePrimitive>& outTriangles
+) const
+{
+    PROFILE_SCOPE("TriangleProcessing");
+    const MeshStreams& streams = mesh.GetStreams();
+    outTriangles.reserve(mesh.GetIndexCount() / 3);
 
-        outTriangles.push_back(TrianglePrimitive{ v0, v1, v2 });
+    if (streams.shortIndices.empty())
+    {
+        AssembleTriangles(vertexOutputs, streams.indices, outTriangles);
+    }
+    else
+    {
+        AssembleTriangles(vertexOutputs, streams.shortIndices, outTriangles);
     }
 }
 
 void RenderPipeline::_RunRasterization(
-    const std::vector<TrianglePrimitive>& trianglePrimitives,
-    std::vector<Fragment>& outFragments
+    const TrianglePrimitive* trianglePrimitives,
+    size_t triangleCount,
+    ArenaVector<Fragment>& outFragments
 ) const
 {
-    outFragments.reserve(trianglePrimitives.size() * 100);
-    for (const TrianglePrimitive& triangle : trianglePrimitives)
+    PROFILE_SCOPE("Rasterization");
+    for (size_t i = 0; i < triangleCount; ++i)
     {
+        const TrianglePrimitive& triangle = trianglePrimitives[i];
         if (_IsFrustumCulled(triangle))
         {
+            _drawStatistics.trianglesCulledNearPlane++;
             continue;
         }
         _RasterizeSingleTriangle(triangle, outFragments);
@@ -197,7 +912,7 @@ bool RenderPipeline::_IsFrustumCulled(
 
 void RenderPipeline::_RasterizeSingleTriangle(
     const TrianglePrimitive& tri,
-    std::vector<Fragment>& outFragments
+    ArenaVector<Fragment>& outFragments
 ) const
 {
     Vec3 ndc0 = Vec3(tri.v0.positionCS.x / tri.v0.positionCS.w,
@@ -210,60 +925,215 @@ void RenderPipeline::_RasterizeSingleTriangle(
         tri.v2.positionCS.y / tri.v2.positionCS.w,
         tri.v2.positionCS.z / tri.v2.positionCS.w);
 
+    const float viewportX = static_cast<float>(_viewport.x);
+    const float viewportY = static_cast<float>(_viewport.y);
     Vec3 p0_ss = Vec3(
-        (ndc0.x + 1.0f) * 0.5f * _width,
-        (1.0f - ndc0.y) * 0.5f * _height,
+        viewportX + (ndc0.x + 1.0f) * 0.5f * _viewport.width,
+        viewportY + (1.0f - ndc0.y) * 0.5f * _viewport.height,
         ndc0.z
     );
     Vec3 p1_ss = Vec3(
-        (ndc1.x + 1.0f) * 0.5f * _width,
-        (1.0f - ndc1.y) * 0.5f * _height,
+        viewportX + (ndc1.x + 1.0f) * 0.5f * _viewport.width,
+        viewportY + (1.0f - ndc1.y) * 0.5f * _viewport.height,
         ndc1.z
     );
     Vec3 p2_ss = Vec3(
-        (ndc2.x + 1.0f) * 0.5f * _width,
-        (1.0f - ndc2.y) * 0.5f * _height,
+        viewportX + (ndc2.x + 1.0f) * 0.5f * _viewport.width,
+        viewportY + (1.0f - ndc2.y) * 0.5f * _viewport.height,
         ndc2.z
     );
 
-    int minX = std::max(0, static_cast<int>(std::floor(std::min({ p0_ss.x, p1_ss.x, p2_ss.x }))));
-    int maxX = std::min(_width - 1, static_cast<int>(std::ceil(std::max({ p0_ss.x, p1_ss.x, p2_ss.x }))));
-    int minY = std::max(0, static_cast<int>(std::floor(std::min({ p0_ss.y, p1_ss.y, p2_ss.y }))));
-    int maxY = std::min(_height - 1, static_cast<int>(std::ceil(std::max({ p0_ss.y, p1_ss.y, p2_ss.y }))));
+    int minX = std::max(_scissor.x, static_cast<int>(std::floor(std::min({ p0_ss.x, p1_ss.x, p2_ss.x }))));
+    int maxX = std::min(_scissor.x + _scissor.width - 1, static_cast<int>(std::ceil(std::max({ p0_ss.x, p1_ss.x, p2_ss.x }))));
+    int minY = std::max(_scissor.y, static_cast<int>(std::floor(std::min({ p0_ss.y, p1_ss.y, p2_ss.y }))));
+    int maxY = std::min(_scissor.y + _scissor.height - 1, static_cast<int>(std::ceil(std::max({ p0_ss.y, p1_ss.y, p2_ss.y }))));
+
+    if (minX > maxX || minY > maxY)
+    {
+        _drawStatistics.trianglesCulledOffscreen++;
+        return;
+    }
+
+    // Same test as _ComputeBarycentricCoords, which would reject every pixel of this triangle
+    Vec3 edge0 = p1_ss - p0_ss; edge0.z = 0;
+    Vec3 edge1 = p2_ss - p0_ss; edge1.z = 0;
+    float d01 = edge0.dot(edge1);
+    if (std::abs(edge0.dot(edge0) * edge1.dot(edge1) - d01 * d01) < 1e-6f)
+    {
+        _drawStatistics.trianglesCulledDegenerate++;
+        return;
+    }
+
+    _drawStatistics.trianglesRasterized++;
+    _drawStatistics.boundingBoxPixelsTested += static_cast<uint64_t>(maxX - minX + 1) * (maxY - minY + 1);
+
+    ScreenTriangle screen;
+    screen.p0_ss = p0_ss;
+    screen.p1_ss = p1_ss;
+    screen.p2_ss = p2_ss;
+    screen.inv_w0 = 1.0f / tri.v0.positionCS.w;
+    screen.inv_w1 = 1.0f / tri.v1.positionCS.w;
+    screen.inv_w2 = 1.0f / tri.v2.positionCS.w;
+
+    // Screen-space depth is a plane, its slope moves z_depth to each MSAA sample
+    float area = edge0.x * edge1.y - edge1.x * edge0.y;
+    float dz1 = p1_ss.z - p0_ss.z;
+    float dz2 = p2_ss.z - p0_ss.z;
+    screen.depthDdx = (dz1 * edge1.y - dz2 * edge0.y) / area;
+    screen.depthDdy = (dz2 * edge0.x - dz1 * edge1.x) / area;
 
-    float inv_w0 = 1.0f / tri.v0.positionCS.w;
-    float inv_w1 = 1.0f / tri.v1.positionCS.w;
-    float inv_w2 = 1.0f / tri.v2.positionCS.w;
+    Vec2 duv1 = tri.v1.varyings.uv * screen.inv_w1 - tri.v0.varyings.uv * screen.inv_w0;
+    Vec2 duv2 = tri.v2.varyings.uv * screen.inv_w2 - tri.v0.varyings.uv * screen.inv_w0;
+    float dq1 = screen.inv_w1 - screen.inv_w0;
+    float dq2 = screen.inv_w2 - screen.inv_w0;
+    screen.uvOverWDdx = (duv1 * edge1.y - duv2 * edge0.y) * (1.0f / area);
+    screen.uvOverWDdy = (duv2 * edge0.x - duv1 * edge1.x) * (1.0f / area);
+    screen.invWDdx = (dq1 * edge1.y - dq2 * edge0.y) / area;
+    screen.invWDdy = (dq2 * edge0.x - dq1 * edge1.x) / area;
 
-    for (int y = minY; y <= maxY; ++y)
+    // Walk the bounding box in blocks that match the buffer layout, so consecutive fragments land in the same tile.
+    // A linear buffer is a single block covering the whole bounding box.
+    const int blockSize = (_frameBuffer.GetLayout() == BufferLayout::Tiled)
+        ? FrameBuffer::TILE_SIZE
+        : std::max(_renderWidth, _renderHeight);
+
+    for (int blockY = minY - (minY % blockSize); blockY <= maxY; blockY += blockSize)
     {
-        for (int x = minX; x <= maxX; ++x)
+        for (int blockX = minX - (minX % blockSize); blockX <= maxX; blockX += blockSize)
         {
-            Vec3 p_pixel(x + 0.5f, y + 0.5f, 0);
-            Vec3 bary = _ComputeBarycentricCoords(p_pixel, p0_ss, p1_ss, p2_ss);
+            _RasterizeBlock(
+                tri,
+                screen,
+                std::max(minX, blockX),
+                std::max(minY, blockY),
+                std::min(maxX, blockX + blockSize - 1),
+                std::min(maxY, blockY + blockSize - 1),
+                outFragments
+            );
+        }
+    }
+}
 
-            if (bary.x < -0.001f || bary.y < -0.001f || bary.z < -0.001f)
+void RenderPipeline::_RasterizeBlock(
+    const TrianglePrimitive& tri,
+    const ScreenTriangle& screen,
+    int minX, int minY, int maxX, int maxY,
+    ArenaVector<Fragment>& outFragments
+) const
+{
+    Fragment frag;
+    const int cellWidth = GetShadingRateWidth(_boundShadingRate);
+    const int cellHeight = GetShadingRateHeight(_boundShadingRate);
+    if (cellWidth == 1 && cellHeight == 1)
+    {
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
             {
-                continue;
+                if (_BuildFragment(tri, screen, x, y, frag))
+                {
+                    outFragments.push_back(frag);
+                }
             }
+        }
+        return;
+    }
 
-            float z_depth = bary.x * p0_ss.z + bary.y * p1_ss.z + bary.z * p2_ss.z;
-
-            Varyings interpolatedVaryings = _InterpolateVaryings(
-                tri.v0.varyings, tri.v1.varyings, tri.v2.varyings,
-                inv_w0, inv_w1, inv_w2,
-                bary
-            );
+    // Coarse shading: visit the block one screen-aligned cell at a time, the first covered pixel of a cell
+    // is shaded and the others point at it. Blocks are tile- or bounding-box-sized, so cells never straddle two.
+    for (int cellY = minY - (minY % cellHeight); cellY <= maxY; cellY += cellHeight)
+    {
+        for (int cellX = minX - (minX % cellWidth); cellX <= maxX; cellX += cellWidth)
+        {
+            int shadingSource = -1;
+            for (int y = std::max(minY, cellY); y <= std::min(maxY, cellY + cellHeight - 1); ++y)
+            {
+                for (int x = std::max(minX, cellX); x <= std::min(maxX, cellX + cellWidth - 1); ++x)
+                {
+                    if (!_BuildFragment(tri, screen, x, y, frag))
+                    {
+                        continue;
+                    }
+                    frag.shadingSource = shadingSource;
+                    if (shadingSource < 0)
+                    {
+                        shadingSource = static_cast<int>(outFragments.size());
+                    }
+                    outFragments.push_back(frag);
+                }
+            }
+        }
+    }
+}
 
-            Fragment frag;
-            frag.x = x;
-            frag.y = y;
-            frag.z_depth = z_depth;
-            frag.interpolatedVaryings = interpolatedVaryings;
+bool RenderPipeline::_BuildFragment(
+    const TrianglePrimitive& tri,
+    const ScreenTriangle& screen,
+    int x, int y,
+    Fragment& outFragment
+) const
+{
+    Vec3 p_pixel(x + 0.5f, y + 0.5f, 0);
+    Vec3 bary = _ComputeBarycentricCoords(p_pixel, screen.p0_ss, screen.p1_ss, screen.p2_ss);
+    bool isCenterCovered = bary.x >= -0.001f && bary.y >= -0.001f && bary.z >= -0.001f;
 
-            outFragments.push_back(frag);
+    uint32_t coverageMask = isCenterCovered ? 1u : 0u;
+    if (_frameBuffer.GetSampleCount() > 1)
+    {
+        // When the center is outside, varyings come from the first covered sample so they are not extrapolated
+        coverageMask = 0;
+        Vec3 firstCoveredBary;
+        for (int s = 0; s < FrameBuffer::MAX_SAMPLE_COUNT; ++s)
+        {
+            Vec3 p_sample(p_pixel.x + MSAA_SAMPLE_OFFSETS[s][0], p_pixel.y + MSAA_SAMPLE_OFFSETS[s][1], 0);
+            Vec3 sampleBary = _ComputeBarycentricCoords(p_sample, screen.p0_ss, screen.p1_ss, screen.p2_ss);
+            if (sampleBary.x < -0.001f || sampleBary.y < -0.001f || sampleBary.z < -0.001f)
+            {
+                continue;
+            }
+            if (coverageMask == 0)
+            {
+                firstCoveredBary = sampleBary;
+            }
+            coverageMask |= 1u << s;
+        }
+        if (coverageMask != 0 && !isCenterCovered)
+        {
+            bary = firstCoveredBary;
         }
     }
+
+    if (coverageMask == 0)
+    {
+        return false;
+    }
+
+    // Depth is the plane value at the pixel center, the framebuffer stage offsets it to each sample
+    float z_depth = isCenterCovered
+        ? bary.x * screen.p0_ss.z + bary.y * screen.p1_ss.z + bary.z * screen.p2_ss.z
+        : screen.p0_ss.z + screen.depthDdx * (p_pixel.x - screen.p0_ss.x) + screen.depthDdy * (p_pixel.y - screen.p0_ss.y);
+
+    Varyings interpolatedVaryings = _InterpolateVaryings(
+        tri.v0.varyings, tri.v1.varyings, tri.v2.varyings,
+        screen.inv_w0, screen.inv_w1, screen.inv_w2,
+        bary
+    );
+
+    outFragment.x = x;
+    outFragment.y = y;
+    outFragment.z_depth = z_depth;
+    outFragment.interpolatedVaryings = interpolatedVaryings;
+    outFragment.shadingSource = -1;
+    outFragment.coverageMask = coverageMask;
+    outFragment.depthDdx = screen.depthDdx;
+    outFragment.depthDdy = screen.depthDdy;
+
+    // Quotient rule on uv = (uv / w) / (1 / w)
+    float inv_w = bary.x * screen.inv_w0 + bary.y * screen.inv_w1 + bary.z * screen.inv_w2;
+    float w = 1.0f / inv_w;
+    outFragment.uvDdx = (screen.uvOverWDdx - interpolatedVaryings.uv * screen.invWDdx) * w;
+    outFragment.uvDdy = (screen.uvOverWDdy - interpolatedVaryings.uv * screen.invWDdy) * w;
+    return true;
 }
 
 Vec3 RenderPipeline::_ComputeBarycentricCoords(
@@ -313,56 +1183,209 @@ Varyings RenderPipeline::_InterpolateVaryings(
         (v1.normalVS * inv_w1 * bary.y) +
         (v2.normalVS * inv_w2 * bary.z);
 
+    Vec2 uv_interp =
+        (v0.uv * inv_w0 * bary.x) +
+        (v1.uv * inv_w1 * bary.y) +
+        (v2.uv * inv_w2 * bary.z);
+
     Varyings finalVaryings;
     finalVaryings.positionVS = posVS_interp * z_pixel_correction;
     finalVaryings.normalVS = normVS_interp * z_pixel_correction;
+    finalVaryings.uv = uv_interp * z_pixel_correction;
 
     return finalVaryings;
 }
 
 void RenderPipeline::_RunFragmentProcessing(
-    const std::vector<Fragment>& fragments,
-    std::vector<PixelData>& outPixelDatas
+    const ArenaVector<Fragment>& fragments,
+    ArenaVector<PixelData>& outPixelDatas
 ) const
 {
-    outPixelDatas.reserve(fragments.size());
+    PROFILE_SCOPE("FragmentProcessing");
+    const size_t firstPixel = outPixelDatas.size();
+    outPixelDatas.resize(firstPixel + fragments.size());
+    PixelData* pixelDatas = outPixelDatas.data() + firstPixel;
+    std::atomic<uint64_t> fragmentsShaded{ 0 };
 
-    for (const Fragment& frag : fragments)
+    // Each fragment writes its own slot, so the output order does not depend on how the jobs were split
+    JobSystem::ParallelFor(fragments.size(), FRAGMENT_GRAIN_SIZE, [&](size_t first, size_t last)
     {
-        Vec3 shadedColor = _boundShader->RunFragmentShader(
-            frag,
-            _camera,
-            _light,
-            *_boundProperties
-        );
-
-        PixelData pixelData;
-        pixelData.x = frag.x;
-        pixelData.y = frag.y;
-        pixelData.z_depth = frag.z_depth;
-        pixelData.color = shadedColor;
+        uint64_t shadedCount = 0;
+        for (size_t i = first; i < last; ++i)
+        {
+            const Fragment& frag = fragments[i];
+            PixelData& pixelData = pixelDatas[i];
+            pixelData.x = frag.x;
+            pixelData.y = frag.y;
+            pixelData.z_depth = frag.z_depth;
+            pixelData.coverageMask = frag.coverageMask;
+            pixelData.depthDdx = frag.depthDdx;
+            pixelData.depthDdy = frag.depthDdy;
+            if (frag.shadingSource < 0)
+            {
+                pixelData.color = _boundShader->RunFragmentShader(
+                    frag,
+                    _camera,
+                    _light,
+                    *_boundProperties
+                );
+                shadedCount++;
+            }
+        }
+        fragmentsShaded.fetch_add(shadedCount, std::memory_order_relaxed);
+    });
+    _drawStatistics.fragmentsShaded += fragmentsShaded.load(std::memory_order_relaxed);
 
-        outPixelDatas.push_back(pixelData);
+    // Coarse shading broadcasts the color of an earlier fragment of the same cell. The source may have been in
+    // another job, so this waits until every shader invocation is done.
+    if (_boundShadingRate != ShadingRate::Rate1x1)
+    {
+        for (size_t i = 0; i < fragments.size(); ++i)
+        {
+            if (fragments[i].shadingSource >= 0)
+            {
+                pixelDatas[i].color = pixelDatas[fragments[i].shadingSource].color;
+            }
+        }
     }
 }
 
 void RenderPipeline::_RunFramebufferOperations(
-    const std::vector<PixelData>& shadedPixels
+    const ArenaVector<PixelData>& shadedPixels
 )
 {
+    PROFILE_SCOPE("FramebufferOperations");
+    _isUpscaleDirty = true;
+    if (_frameBuffer.GetPixelStorage() == PixelStorage::PackedAtomic)
+    {
+        _RunAtomicFramebufferOperations(shadedPixels);
+        return;
+    }
+    if (_frameBuffer.GetSampleCount() > 1)
+    {
+        _RunMultisampleFramebufferOperations(shadedPixels);
+        return;
+    }
+
     for (const auto& pixel : shadedPixels)
     {
-        int index = pixel.y * _width + pixel.x;
+        if (pixel.x < 0 || pixel.x >= _renderWidth || pixel.y < 0 || pixel.y >= _renderHeight)
+        {
+            continue;
+        }
 
-        if (pixel.x < 0 || pixel.x >= _width || pixel.y < 0 || pixel.y >= _height)
+        _frameBuffer.TouchTile(pixel.x, pixel.y);
+        int index = _frameBuffer.GetIndex(pixel.x, pixel.y);
+
+        if (pixel.z_depth < _frameBuffer.GetDepth(index))
+        {
+            _frameBuffer.SetPixel(index, pixel.z_depth, pixel.color);
+            _drawStatistics.depthTestPasses++;
+        }
+        else
+        {
+            _drawStatistics.depthTestFailures++;
+        }
+    }
+}
+
+void RenderPipeline::_RunMultisampleFramebufferOperations(
+    const ArenaVector<PixelData>& shadedPixels
+)
+{
+    for (const auto& pixel : shadedPixels)
+    {
+        if (pixel.x < 0 || pixel.x >= _renderWidth || pixel.y < 0 || pixel.y >= _renderHeight)
         {
             continue;
         }
 
-        if (pixel.z_depth < _depthBuffer[index])
+        _frameBuffer.TouchTile(pixel.x, pixel.y);
+        int index = _frameBuffer.GetIndex(pixel.x, pixel.y);
+
+        // The shaded color is shared by every covered sample, depth is tested per sample
+        bool isAnySamplePassed = false;
+        for (int s = 0; s < FrameBuffer::MAX_SAMPLE_COUNT; ++s)
+        {
+            if ((pixel.coverageMask & (1u << s)) == 0)
+            {
+                continue;
+            }
+            float sampleDepth = pixel.z_depth + pixel.depthDdx * MSAA_SAMPLE_OFFSETS[s][0] + pixel.depthDdy * MSAA_SAMPLE_OFFSETS[s][1];
+            if (sampleDepth < _frameBuffer.GetSampleDepth(index, s))
+            {
+                _frameBuffer.SetSample(index, s, sampleDepth, pixel.color);
+                isAnySamplePassed = true;
+            }
+        }
+
+        if (isAnySamplePassed)
         {
-            _depthBuffer[index] = pixel.z_depth;
-            _colorBuffer[index] = pixel.color;
+            _drawStatistics.depthTestPasses++;
+        }
+        else
+        {
+            _drawStatistics.depthTestFailures++;
         }
     }
+}
+
+void RenderPipeline::_RunAtomicFramebufferOperations(
+    const ArenaVector<PixelData>& shadedPixels
+)
+{
+    // No tiles to touch, the packed buffer is cleared eagerly
+    _frameBuffer.InvalidateResolve();
+    const int sampleCount = _frameBuffer.GetSampleCount();
+    std::atomic<uint64_t> depthTestPasses{ 0 };
+    std::atomic<uint64_t> depthTestFailures{ 0 };
+
+    // Fragments of one triangle may race for the same pixel as freely as those of different triangles, so a few
+    // huge triangles split as evenly as many small ones
+    JobSystem::ParallelFor(shadedPixels.size(), FRAMEBUFFER_GRAIN_SIZE, [&](size_t first, size_t last)
+    {
+        uint64_t passes = 0;
+        uint64_t failures = 0;
+        for (size_t i = first; i < last; ++i)
+        {
+            const PixelData& pixel = shadedPixels[i];
+            if (pixel.x < 0 || pixel.x >= _renderWidth || pixel.y < 0 || pixel.y >= _renderHeight)
+            {
+                continue;
+            }
+
+            int index = _frameBuffer.GetIndex(pixel.x, pixel.y);
+            bool isAnySamplePassed = false;
+            if (sampleCount == 1)
+            {
+                isAnySamplePassed = _frameBuffer.TestAndSetPacked(index, 0, pixel.z_depth, pixel.color);
+            }
+            else
+            {
+                for (int s = 0; s < sampleCount; ++s)
+                {
+                    if ((pixel.coverageMask & (1u << s)) == 0)
+                    {
+                        continue;
+                    }
+                    float sampleDepth = pixel.z_depth + pixel.depthDdx * MSAA_SAMPLE_OFFSETS[s][0] + pixel.depthDdy * MSAA_SAMPLE_OFFSETS[s][1];
+                    isAnySamplePassed |= _frameBuffer.TestAndSetPacked(index, s, sampleDepth, pixel.color);
+                }
+            }
+
+            if (isAnySamplePassed)
+            {
+                passes++;
+            }
+            else
+            {
+                failures++;
+            }
+        }
+        depthTestPasses.fetch_add(passes, std::memory_order_relaxed);
+        depthTestFailures.fetch_add(failures, std::memory_order_relaxed);
+    });
+
+    _drawStatistics.depthTestPasses += depthTestPasses.load(std::memory_order_relaxed);
+    _drawStatistics.depthTestFailures += depthTestFailures.load(std::memory_order_relaxed);
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <chrono>
 
 #include "Vec3.h"
 #include "Camera.h"
@@ -16,46 +18,193 @@
 #include "IShaderProperties.h"
 #include "MeshData.h"
 #include "PipelineData.h"
+#include "FrameBuffer.h"
+#include "VertexCache.h"
+#include "FrameArena.h"
+#include "PipelineStatistics.h"
+#include "PostProcessStage.h"
+
+// One camera of a multi-view draw and the part of the output it renders to, in output pixels.
+// The camera's aspect ratio should match the viewport's.
+struct RenderView
+{
+    Camera camera;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
 
 class RenderPipeline
 {
+    // Times the private stages in isolation (BenchmarkMain.cpp)
+    friend class PipelineBenchmark;
+
 public:
     RenderPipeline(int width, int height);
     ~RenderPipeline() = default;
 
     void SetCamera(const Camera& camera);
+    const Camera& GetCamera() const { return _camera; }
     void SetLight(const Light& light);
+
+    // Frame-level API for skipping unchanged frames. sceneKey describes the draw list (see FrameHash);
+    // the pipeline adds its own camera, light and settings versions. BeginFrame returns false when the key
+    // matches the last completed frame, in which case the color buffer still holds that frame and the caller
+    // skips its draws and EndFrame. Otherwise the buffers are cleared and the frame is recorded on EndFrame.
+    bool BeginFrame(uint64_t sceneKey);
+    void EndFrame();
+
     void ClearBuffers();
     void Draw(const MeshData& mesh, const Vec3& objectPosition);
+
+    // Draws the mesh once per view, each into its own viewport. The model-to-world half of vertex shading and the
+    // world-space bounds are computed once for all views; a view whose frustum misses the bounds is skipped, the
+    // others run the view stage, rasterization and shading inside their viewport. The vertex cache is not used.
+    // The pipeline camera is left as it is, so a caller of BeginFrame should fold the views into its sceneKey.
+    void DrawMultiView(const MeshData& mesh, const Vec3& objectPosition, const std::vector<RenderView>& views);
+
+    // Thumbnail batch: the mesh is rasterized once per distinct shader into cellWidth x cellHeight with the pipeline
+    // camera and the nearest fragment of every pixel is kept; then only the fragment shader runs, once per material
+    // over those fragments. Material i lands in cell (i % columns, i / columns) of the returned row-major atlas,
+    // columns * cellWidth pixels wide, on black. Coarse shading rates and MSAA are not applied. The frame buffer is
+    // left untouched; the stage data lives in the frame arena until the next ClearBuffers.
+    std::vector<Vec3> RenderMaterialAtlas(
+        const MeshData& mesh,
+        const Vec3& objectPosition,
+        const std::vector<const Material*>& materials,
+        int cellWidth,
+        int cellHeight,
+        int columns);
     const std::vector<Vec3>& GetFinalColorBuffer() const;
+
+    // Writes the output-size row-major depth to out, nearest-upscaled from the render size; infinity where nothing
+    // was drawn
+    void CopyFinalDepthBuffer(float* out) const;
+
+    // Display stage: exposure, tonemapping, optional sRGB encode and FXAA into RGBA8 (see PostProcessStage).
+    // The default settings give the plain clamp to [0, 1]. A change counts as a settings change for BeginFrame.
+    void SetPostProcess(const PostProcessSettings& settings);
+    const PostProcessSettings& GetPostProcess() const { return _postProcess.GetSettings(); }
+
+    // Runs the display stage over GetFinalColorBuffer() into GetWidth() * GetHeight() * 4 bytes
+    void ResolveDisplayPixels(std::vector<uint8_t>& outRGBA);
+
+    // Same over any row-major buffer, such as a render graph's composite
+    void ApplyPostProcess(const std::vector<Vec3>& color, int width, int height, std::vector<uint8_t>& outRGBA);
+    double GetLastPostProcessMs() const { return _postProcess.GetLastMs(); }
     void BindMaterial(Material* material);
 
+    // 4x MSAA: coverage and depth are tested at 4 samples per pixel while the fragment shader still runs once
+    // per pixel per triangle; samples are averaged into GetFinalColorBuffer(). 1 turns it off. Clears the buffers.
+    void SetSampleCount(int sampleCount);
+    int GetSampleCount() const { return _frameBuffer.GetSampleCount(); }
+
+    // Tiled layout keeps a small triangle inside one or two cache lines; the final color buffer is always row-major
+    void SetBufferLayout(BufferLayout layout);
+    BufferLayout GetBufferLayout() const { return _frameBuffer.GetLayout(); }
+
+    // PackedAtomic resolves the shaded pixels of a draw into the frame buffer from every job system thread at
+    // once, with a lock-free depth test per sample, instead of in one serial loop. Colors are stored as RGB9E5.
+    // Clears the buffers.
+    void SetPixelStorage(PixelStorage storage);
+    PixelStorage GetPixelStorage() const { return _frameBuffer.GetPixelStorage(); }
+
+    // Cross-frame cache of assembled triangles per (mesh, transform, camera, shader); 0 bytes disables it
+    void SetVertexCacheBudget(size_t budgetBytes) { _vertexCache.SetBudget(budgetBytes); }
+    VertexCacheStats GetVertexCacheStats() const { return _vertexCache.GetStats(); }
+    void ResetVertexCacheStats() { _vertexCache.ResetStats(); }
+
+    // All transient stage data of a frame lives in one arena that ClearBuffers rewinds.
+    // A Draw that would take the arena past the ceiling throws std::runtime_error before it touches the frame buffer.
+    void SetFrameMemoryCeiling(size_t ceilingBytes) { _frameArena.SetCeiling(ceilingBytes); }
+    FrameArenaStats GetFrameArenaStats() const { return _frameArena.GetStats(); }
+
+    // Counters and stage timings of the last Draw, and summed over the frame since BeginFrame/ClearBuffers
+    const PipelineStatistics& GetDrawStatistics() const { return _drawStatistics; }
+    PipelineStatistics GetFrameStatistics() const;
+
+    // Dynamic resolution. The frame is rasterized at scale * output size and upscaled bilinearly into
+    // GetFinalColorBuffer(), which always has the output size. A new scale takes effect at the next
+    // BeginFrame/ClearBuffers. With a target frame time set, EndFrame adjusts the scale between minScale and 1
+    // from the measured BeginFrame-to-EndFrame time; 0 turns the controller off.
+    void SetRenderScale(float scale);
+    float GetRenderScale() const { return _renderScale; }
+    void SetTargetFrameTime(double targetMs, float minScale = 0.5f);
+    double GetLastFrameMs() const { return _lastFrameMs; }
+
+    // Bucket rendering: the output becomes the window at (x, y) of a larger imageWidth x imageHeight image.
+    // Triangles are projected for the whole image and rasterized only where they overlap the window, so a big
+    // image can be rendered window by window through small buffers (see BucketRenderer). The camera should have
+    // the image's aspect ratio. Counts as a settings change and takes effect at the next BeginFrame/ClearBuffers;
+    // the render scale should stay 1 and DrawMultiView viewports stay relative to the window.
+    void SetImageWindow(int imageWidth, int imageHeight, int x, int y);
+
+    // Output size
     int GetWidth() const { return _width; }
     int GetHeight() const { return _height; }
 
+    // Size actually rasterized this frame
+    int GetRenderWidth() const { return _renderWidth; }
+    int GetRenderHeight() const { return _renderHeight; }
+    uint64_t GetCameraVersion() const { return _cameraVersion; }
+    uint64_t GetLightVersion() const { return _lightVersion; }
+
 private:
     void _BindShader(const IShader* shader);
+    void _ApplyRenderScale();
+    void _UpdateRenderScale(double frameMs);
+    void _UpscaleColor(const std::vector<Vec3>& source) const;
     void _BindProperties(IShaderProperties* properties);
-    void _InitializeDepthBuffer();
-    void _InitializeColorBuffer();
+
+    // Region of the render target the rasterizer writes to, in render pixels
+    struct Viewport
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    Viewport _ScaleViewport(const RenderView& view) const;
+
+    // Vertex to raster stages into _viewport with the bound shader, then the nearest fragment per viewport pixel
+    void _ResolveVisibleFragments(
+        const MeshData& mesh,
+        const Vec3& objectPosition,
+        std::vector<Fragment>& outFragments
+    );
 
     // Pipeline Stages
+    // Decodes quantized streams on the fly, see MeshQuantization
     void _RunVertexProcessing(
-        const std::vector<Vec3>& positions,
-        const std::vector<Vec3>& normals,
+        const MeshData& mesh,
         const Vec3& objectPosition,
-        std::vector<VertexOutput>& outVertexOutputs
+        ArenaVector<VertexOutput>& outVertexOutputs
+    ) const;
+
+    // Multi-view halves of _RunVertexProcessing: the world stage once per draw, the view stage once per view
+    void _RunWorldProcessing(
+        const MeshData& mesh,
+        const Vec3& objectPosition,
+        ArenaVector<WorldVertex>& outWorldVertices
+    ) const;
+
+    void _RunViewProcessing(
+        const ArenaVector<WorldVertex>& worldVertices,
+        ArenaVector<VertexOutput>& outVertexOutputs
     ) const;
 
     void _RunTriangleProcessing(
-        const std::vector<VertexOutput>& vertexOutputs,
-        const std::vector<unsigned int>& indices,
-        std::vector<TrianglePrimitive>& outTriangles
+        const ArenaVector<VertexOutput>& vertexOutputs,
+        const MeshData& mesh,
+        ArenaVector<TrianglePrimitive>& outTriangles
     ) const;
 
     void _RunRasterization(
-        const std::vector<TrianglePrimitive>& trianglePrimitives,
-        std::vector<Fragment>& outFragments
+        const TrianglePrimitive* trianglePrimitives,
+        size_t triangleCount,
+        ArenaVector<Fragment>& outFragments
     ) const;
 
     bool _IsFrustumCulled(
@@ -64,7 +213,24 @@ private:
 
     void _RasterizeSingleTriangle(
         const TrianglePrimitive& tri,
-        std::vector<Fragment>& outFragments
+        ArenaVector<Fragment>& outFragments
+    ) const;
+
+    // Per-triangle values shared by every pixel of the triangle
+    struct ScreenTriangle
+    {
+        Vec3 p0_ss, p1_ss, p2_ss;
+        float inv_w0, inv_w1, inv_w2;
+        float depthDdx, depthDdy;
+        Vec2 uvOverWDdx, uvOverWDdy; // uv / w and 1 / w are linear in screen space, their slopes give the UV derivatives
+        float invWDdx, invWDdy;
+    };
+
+    void _RasterizeBlock(
+        const TrianglePrimitive& tri,
+        const ScreenTriangle& screen,
+        int minX, int minY, int maxX, int maxY,
+        ArenaVector<Fragment>& outFragments
     ) const;
 
     Vec3 _ComputeBarycentricCoords(
@@ -74,6 +240,13 @@ private:
         const Vec3& c
     ) const;
 
+    bool _BuildFragment(
+        const TrianglePrimitive& tri,
+        const ScreenTriangle& screen,
+        int x, int y,
+        Fragment& outFragment
+    ) const;
+
     Varyings _InterpolateVaryings(
         const Varyings& v0, const Varyings& v1, const Varyings& v2,
         float inv_w0, float inv_w1, float inv_w2,
@@ -81,30 +254,78 @@ private:
     ) const;
 
     void _RunFragmentProcessing(
-        const std::vector<Fragment>& fragments,
-        std::vector<PixelData>& outPixelDatas
+        const ArenaVector<Fragment>& fragments,
+        ArenaVector<PixelData>& outPixelDatas
     ) const;
 
     void _RunFramebufferOperations(
-        const std::vector<PixelData>& shadedPixels
+        const ArenaVector<PixelData>& shadedPixels
+    );
+
+    void _RunMultisampleFramebufferOperations(
+        const ArenaVector<PixelData>& shadedPixels
+    );
+
+    // PackedAtomic storage, any sample count
+    void _RunAtomicFramebufferOperations(
+        const ArenaVector<PixelData>& shadedPixels
     );
 
     // Member Data
     int _width;
     int _height;
 
-    std::vector<float> _depthBuffer;
-    std::vector<Vec3> _colorBuffer;
+    // Dynamic resolution
+    int _renderWidth;
+    int _renderHeight;
+    Viewport _viewport;    // Where NDC maps to: the whole image outside of DrawMultiView, see SetImageWindow
+    Viewport _scissor;     // Pixels the rasterizer may cover: the render target, a view or an atlas cell
+    Viewport _imageWindow; // The image relative to the output, in output pixels
+    float _renderScale = 1.0f;
+    float _pendingRenderScale = 1.0f;
+    float _minRenderScale = 0.5f;
+    double _targetFrameMs = 0.0;
+    double _lastFrameMs = 0.0;
+    std::chrono::steady_clock::time_point _frameStartTime;
+
+    // Upscale source column and weight per output column, rebuilt when the scale changes
+    std::vector<int> _upscaleColumns;
+    std::vector<float> _upscaleColumnWeights;
+    mutable std::vector<Vec3> _upscaledColor;
+    mutable std::vector<float> _resolvedDepth; // Render-size depth, only used when upscaling
+    mutable bool _isUpscaleDirty = true;
+
+    FrameBuffer _frameBuffer;
+    PostProcessStage _postProcess;
 
     Camera _camera;
     Light _light;
 
+    // State versions, bumped only when the value actually changes
+    uint64_t _cameraVersion = NextStateVersion();
+    uint64_t _lightVersion = NextStateVersion();
+    uint64_t _settingsVersion = NextStateVersion();
+
+    // Frame result cache
+    uint64_t _currentFrameKey = 0;
+    uint64_t _completedFrameKey = 0;
+    bool _isInsideFrame = false;
+    bool _hasCompletedFrame = false;
+
     const IShader* _boundShader = nullptr;
     IShaderProperties* _boundProperties = nullptr;
+    ShadingRate _boundShadingRate = ShadingRate::Rate1x1;
+
+    // Per-draw stage data, allocated from the frame arena and rewound by ClearBuffers
+    FrameArena _frameArena;
+    ArenaVector<WorldVertex> _worldVertexCache;
+    ArenaVector<VertexOutput> _vertexOutputCache;
+    ArenaVector<TrianglePrimitive> _triangleCache;
+    ArenaVector<Fragment> _fragmentCache;
+    ArenaVector<PixelData> _pixelCache;
+    VertexCache _vertexCache;
 
-    // Caches
-    std::vector<VertexOutput> _vertexOutputCache;
-    std::vector<TrianglePrimitive> _triangleCache;
-    std::vector<Fragment> _fragmentCache;
-    std::vector<PixelData> _pixelCache;
+    // Statistics, mutable so the const stages can count what they do
+    mutable PipelineStatistics _drawStatistics;
+    PipelineStatistics _frameStatistics;
 };
\ No newline at end of file
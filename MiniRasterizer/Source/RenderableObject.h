@@ -10,6 +10,8 @@
 #include <memory>
 #include <utility>
 #include <stdexcept>
+#include <cstdint>
+#include "StateVersion.h"
 
 class RenderableObject
 {
@@ -32,18 +34,21 @@ public:
     void SetPosition(const Vec3& pos)
     {
         _position = pos;
+        _version = NextStateVersion();
     }
 
     void SetMesh(std::shared_ptr<MeshData> mesh)
     {
         if (!mesh) { throw std::runtime_error("Cannot set null mesh"); }
         _mesh = std::move(mesh);
+        _version = NextStateVersion();
     }
 
     void SetMaterial(std::shared_ptr<Material> material)
     {
         if (!material) { throw std::runtime_error("Cannot set null material"); }
         _material = std::move(material);
+        _version = NextStateVersion();
     }
 
     const Vec3& GetPosition() const
@@ -61,8 +66,15 @@ public:
         return _material;
     }
 
+    // Changes with position, mesh or material assignment; the mesh and material carry their own versions
+    uint64_t GetVersion() const
+    {
+        return _version;
+    }
+
 private:
-    Vec3 _position;
     std::shared_ptr<MeshData> _mesh;
     std::shared_ptr<Material> _material;
+    Vec3 _position;
+    uint64_t _version = NextStateVersion();
 };
\ No newline at end of file
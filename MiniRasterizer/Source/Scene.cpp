@@ -0,0 +1,516 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "Scene.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Frustum.h"
+
+namespace
+{
+    // Leaves are grown by this fraction of the object's size on each side, plus a small absolute margin,
+    // so an object nudged by a gizmo or an animation stays inside its leaf
+    constexpr float LEAF_MARGIN_SCALE = 0.1f;
+    constexpr float LEAF_MARGIN_MIN = 0.01f;
+
+    MeshBounds Union(const MeshBounds& a, const MeshBounds& b)
+    {
+        return MeshBounds{
+            Vec3(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)),
+            Vec3(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z))
+        };
+    }
+
+    bool Contains(const MeshBounds& outer, const MeshBounds& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+    }
+
+    bool Overlaps(const MeshBounds& a, const MeshBounds& b)
+    {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+            a.min.y <= b.max.y && a.max.y >= b.min.y &&
+            a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+    // Half the surface area, the insertion cost is the growth of this summed over the tree
+    float HalfArea(const MeshBounds& bounds)
+    {
+        Vec3 size = bounds.max - bounds.min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    MeshBounds Grow(const MeshBounds& bounds)
+    {
+        Vec3 size = bounds.max - bounds.min;
+        float margin = std::max({ size.x, size.y, size.z }) * LEAF_MARGIN_SCALE + LEAF_MARGIN_MIN;
+        Vec3 grow(margin, margin, margin);
+        return MeshBounds{ bounds.min - grow, bounds.max + grow };
+    }
+
+    // Slab test; returns the entry distance, or a negative value on a miss
+    float IntersectRay(const MeshBounds& bounds, const Vec3& origin, const Vec3& inverseDirection, float maxDistance)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        const float origins[3] = { origin.x, origin.y, origin.z };
+        const float inverses[3] = { inverseDirection.x, inverseDirection.y, inverseDirection.z };
+        const float mins[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+        const float maxs[3] = { bounds.max.x, bounds.max.y, bounds.max.z };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float t0 = (mins[axis] - origins[axis]) * inverses[axis];
+            float t1 = (maxs[axis] - origins[axis]) * inverses[axis];
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+            // NaN from a zero direction on the slab's boundary leaves the range unchanged
+            tMin = t0 > tMin ? t0 : tMin;
+            tMax = t1 < tMax ? t1 : tMax;
+            if (tMin > tMax)
+            {
+                return -1.0f;
+            }
+        }
+        return tMin;
+    }
+}
+
+SceneObjectId Scene::Add(std::shared_ptr<RenderableObject> object)
+{
+    if (!object)
+    {
+        throw std::runtime_error("Scene: Cannot add a null object.");
+    }
+    SceneObjectId id = static_cast<SceneObjectId>(_entries.size());
+
+    int leaf = _AllocateNode();
+    _nodes[leaf].bounds = Grow(_ComputeObjectBounds(*object));
+    _nodes[leaf].object = id;
+    _InsertLeaf(leaf);
+
+    _entries.push_back(Entry{ std::move(object), leaf });
+    _objectCount++;
+    return id;
+}
+
+void Scene::Remove(SceneObjectId id)
+{
+    _GetEntry(id);
+    Entry& entry = _entries[id];
+    _RemoveLeaf(entry.leaf);
+    _FreeNode(entry.leaf);
+    entry = Entry();
+    _objectCount--;
+}
+
+void Scene::SetPosition(SceneObjectId id, const Vec3& position)
+{
+    _GetEntry(id).object->SetPosition(position);
+    Update(id);
+}
+
+void Scene::SetMesh(SceneObjectId id, std::shared_ptr<MeshData> mesh)
+{
+    _GetEntry(id).object->SetMesh(std::move(mesh));
+    Update(id);
+}
+
+void Scene::Update(SceneObjectId id)
+{
+    const Entry& entry = _GetEntry(id);
+    MeshBounds bounds = _ComputeObjectBounds(*entry.object);
+    if (Contains(_nodes[entry.leaf].bounds, bounds))
+    {
+        return;
+    }
+
+    _RemoveLeaf(entry.leaf);
+    _nodes[entry.leaf].bounds = Grow(bounds);
+    _InsertLeaf(entry.leaf);
+}
+
+const std::shared_ptr<RenderableObject>& Scene::Get(SceneObjectId id) const
+{
+    return _GetEntry(id).object;
+}
+
+void Scene::GetObjects(std::vector<SceneObjectId>& outIds) const
+{
+    outIds.clear();
+    for (size_t id = 0; id < _entries.size(); ++id)
+    {
+        if (_entries[id].object)
+        {
+            outIds.push_back(static_cast<SceneObjectId>(id));
+        }
+    }
+}
+
+void Scene::QueryFrustum(const Camera& camera, std::vector<SceneObjectId>& outIds) const
+{
+    QueryFrustum(Frustum(camera), outIds);
+}
+
+void Scene::QueryFrustum(const Frustum& frustum, std::vector<SceneObjectId>& outIds) const
+{
+    outIds.clear();
+    if (_root == NULL_NODE)
+    {
+        return;
+    }
+
+    // Each node carries the planes its parent still straddled; a node inside all of them takes its whole subtree
+    std::vector<std::pair<int, unsigned int>> stack;
+    stack.emplace_back(_root, Frustum::ALL_PLANES);
+    while (!stack.empty())
+    {
+        int index = stack.back().first;
+        unsigned int planeMask = stack.back().second;
+        stack.pop_back();
+
+        const Node& node = _nodes[index];
+        FrustumTest test = frustum.Test(node.bounds, planeMask);
+        if (test == FrustumTest::Outside)
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            // The leaf is grown, an intersecting one is tested again with the object's own bounds
+            if (test == FrustumTest::Inside ||
+                frustum.Test(_ComputeObjectBounds(*_entries[node.object].object), planeMask) != FrustumTest::Outside)
+            {
+                outIds.push_back(node.object);
+            }
+            continue;
+        }
+        if (test == FrustumTest::Inside)
+        {
+            _CollectLeaves(index, outIds);
+            continue;
+        }
+        stack.emplace_back(node.child1, planeMask);
+        stack.emplace_back(node.child2, planeMask);
+    }
+    std::sort(outIds.begin(), outIds.end());
+}
+
+void Scene::QueryBox(const MeshBounds& box, std::vector<SceneObjectId>& outIds) const
+{
+    outIds.clear();
+    if (_root == NULL_NODE)
+    {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = _nodes[index];
+        if (!Overlaps(node.bounds, box))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            // The leaf is grown, the object itself has to overlap too
+            if (Overlaps(_ComputeObjectBounds(*_entries[node.object].object), box))
+            {
+                outIds.push_back(node.object);
+            }
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+    std::sort(outIds.begin(), outIds.end());
+}
+
+bool Scene::Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, SceneRayHit& outHit) const
+{
+    if (_root == NULL_NODE)
+    {
+        return false;
+    }
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    Vec3 inverseDirection(
+        direction.x != 0.0f ? 1.0f / direction.x : infinity,
+        direction.y != 0.0f ? 1.0f / direction.y : infinity,
+        direction.z != 0.0f ? 1.0f / direction.z : infinity);
+
+    // Nodes entered beyond the closest hit so far are skipped
+    bool isHit = false;
+    float closest = maxDistance;
+    std::vector<int> stack;
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = _nodes[index];
+        float t = IntersectRay(node.bounds, origin, inverseDirection, closest);
+        if (t < 0.0f)
+        {
+            continue;
+        }
+        if (!node.IsLeaf())
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+            continue;
+        }
+
+        t = IntersectRay(_ComputeObjectBounds(*_entries[node.object].object), origin, inverseDirection, closest);
+        if (t >= 0.0f && (!isHit || t < closest || (t == closest && node.object < outHit.id)))
+        {
+            isHit = true;
+            closest = t;
+            outHit.id = node.object;
+            outHit.distance = t;
+        }
+    }
+    return isHit;
+}
+
+int Scene::GetTreeHeight() const
+{
+    return _root == NULL_NODE ? 0 : _nodes[_root].height + 1;
+}
+
+const Scene::Entry& Scene::_GetEntry(SceneObjectId id) const
+{
+    if (id >= _entries.size() || !_entries[id].object)
+    {
+        throw std::runtime_error("Scene: Unknown object id " + std::to_string(id) + ".");
+    }
+    return _entries[id];
+}
+
+MeshBounds Scene::_ComputeObjectBounds(const RenderableObject& object)
+{
+    const MeshBounds& bounds = object.GetMesh()->GetBounds();
+    return MeshBounds{ bounds.min + object.GetPosition(), bounds.max + object.GetPosition() };
+}
+
+int Scene::_AllocateNode()
+{
+    if (_freeNode == NULL_NODE)
+    {
+        _nodes.emplace_back();
+        return static_cast<int>(_nodes.size()) - 1;
+    }
+    int index = _freeNode;
+    _freeNode = _nodes[index].parent;
+    _nodes[index] = Node();
+    return index;
+}
+
+void Scene::_FreeNode(int index)
+{
+    _nodes[index].parent = _freeNode;
+    _nodes[index].height = -1;
+    _freeNode = index;
+}
+
+void Scene::_InsertLeaf(int leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Walk down to the sibling whose pairing with the leaf grows the tree's surface area least
+    const MeshBounds leafBounds = _nodes[leaf].bounds;
+    int index = _root;
+    while (!_nodes[index].IsLeaf())
+    {
+        const Node& node = _nodes[index];
+        float area = HalfArea(node.bounds);
+        float combinedArea = HalfArea(Union(node.bounds, leafBounds));
+
+        // Cost of pairing with this node, and the growth every deeper choice adds to this node
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child)
+        {
+            const Node& childNode = _nodes[child];
+            float grownArea = HalfArea(Union(childNode.bounds, leafBounds));
+            return (childNode.IsLeaf() ? grownArea : grownArea - HalfArea(childNode.bounds)) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int sibling = index;
+    const int oldParent = _nodes[sibling].parent;
+    const int newParent = _AllocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].bounds = Union(leafBounds, _nodes[sibling].bounds);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        _root = newParent;
+    }
+    else if (_nodes[oldParent].child1 == sibling)
+    {
+        _nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        _nodes[oldParent].child2 = newParent;
+    }
+
+    _RefitAncestors(_nodes[leaf].parent);
+}
+
+void Scene::_RemoveLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const int parent = _nodes[leaf].parent;
+    const int grandParent = _nodes[parent].parent;
+    const int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    // The sibling takes the parent's place
+    _nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE)
+    {
+        _root = sibling;
+    }
+    else if (_nodes[grandParent].child1 == parent)
+    {
+        _nodes[grandParent].child1 = sibling;
+    }
+    else
+    {
+        _nodes[grandParent].child2 = sibling;
+    }
+    _FreeNode(parent);
+    _nodes[leaf].parent = NULL_NODE;
+
+    _RefitAncestors(grandParent);
+}
+
+void Scene::_RefitAncestors(int index)
+{
+    while (index != NULL_NODE)
+    {
+        index = _Balance(index);
+        Node& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.bounds = Union(_nodes[node.child1].bounds, _nodes[node.child2].bounds);
+        index = node.parent;
+    }
+}
+
+// Rotates the taller grandchild up when the two subtrees of a differ in height by more than one.
+// Returns the node now at a's place.
+int Scene::_Balance(int a)
+{
+    if (_nodes[a].IsLeaf() || _nodes[a].height < 2)
+    {
+        return a;
+    }
+
+    const int b = _nodes[a].child1;
+    const int c = _nodes[a].child2;
+    const int balance = _nodes[c].height - _nodes[b].height;
+    if (balance >= -1 && balance <= 1)
+    {
+        return a;
+    }
+
+    // up is the taller child, which moves into a's place; a keeps the shorter child and takes one of up's children
+    const bool isRaisingC = balance > 1;
+    const int up = isRaisingC ? c : b;
+    const int kept = isRaisingC ? b : c;
+    const int f = _nodes[up].child1;
+    const int g = _nodes[up].child2;
+
+    _nodes[up].child1 = a;
+    _nodes[up].parent = _nodes[a].parent;
+    _nodes[a].parent = up;
+    if (_nodes[up].parent == NULL_NODE)
+    {
+        _root = up;
+    }
+    else if (_nodes[_nodes[up].parent].child1 == a)
+    {
+        _nodes[_nodes[up].parent].child1 = up;
+    }
+    else
+    {
+        _nodes[_nodes[up].parent].child2 = up;
+    }
+
+    // The taller of up's children stays with up, the shorter goes down to a in up's old slot
+    const int stays = _nodes[f].height > _nodes[g].height ? f : g;
+    const int moves = stays == f ? g : f;
+    _nodes[up].child2 = stays;
+    if (isRaisingC)
+    {
+        _nodes[a].child2 = moves;
+    }
+    else
+    {
+        _nodes[a].child1 = moves;
+    }
+    _nodes[moves].parent = a;
+
+    _nodes[a].bounds = Union(_nodes[kept].bounds, _nodes[moves].bounds);
+    _nodes[a].height = 1 + std::max(_nodes[kept].height, _nodes[moves].height);
+    _nodes[up].bounds = Union(_nodes[a].bounds, _nodes[stays].bounds);
+    _nodes[up].height = 1 + std::max(_nodes[a].height, _nodes[stays].height);
+    return up;
+}
+
+void Scene::_CollectLeaves(int index, std::vector<SceneObjectId>& outIds) const
+{
+    std::vector<int> stack;
+    stack.push_back(index);
+    while (!stack.empty())
+    {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+        if (node.IsLeaf())
+        {
+            outIds.push_back(node.object);
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+}
\ No newline at end of file
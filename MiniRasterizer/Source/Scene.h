@@ -0,0 +1,109 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "Vec3.h"
+#include "Camera.h"
+#include "MeshData.h"
+#include "RenderableObject.h"
+
+class Frustum;
+
+// Ids are handed out in increasing order and never reused, so sorting by id gives insertion order
+using SceneObjectId = uint32_t;
+
+struct SceneRayHit
+{
+    SceneObjectId id = 0;
+    float distance = 0.0f; // Along the ray, in units of the direction's length
+};
+
+// The objects of a scene in a dynamic bounding volume hierarchy over their world-space bounds.
+//
+// Leaves hold each object's bounds grown by a margin, so small moves only need the leaf checked; an object that
+// leaves its grown bounds is taken out and reinserted, picking the sibling that grows the tree's surface least,
+// and AVL-style rotations keep the tree balanced on the way back up. Frustum, box and ray queries then descend
+// only into the nodes they touch, which makes culling roughly logarithmic in the object count while few objects
+// are visible. Move objects through SetPosition (or call Update after changing one directly) to keep the tree
+// in step; a moved object that is not updated keeps being culled against its old bounds.
+class Scene
+{
+public:
+    SceneObjectId Add(std::shared_ptr<RenderableObject> object);
+    void Remove(SceneObjectId id);
+
+    void SetPosition(SceneObjectId id, const Vec3& position);
+    void SetMesh(SceneObjectId id, std::shared_ptr<MeshData> mesh);
+
+    // Refits the object after its position or mesh was changed on the object itself
+    void Update(SceneObjectId id);
+
+    // Throws std::runtime_error for an unknown or removed id
+    const std::shared_ptr<RenderableObject>& Get(SceneObjectId id) const;
+
+    size_t GetObjectCount() const { return _objectCount; }
+    bool IsEmpty() const { return _objectCount == 0; }
+
+    // All objects, in insertion order
+    void GetObjects(std::vector<SceneObjectId>& outIds) const;
+
+    // Objects whose bounds may be inside the camera frustum, in insertion order so draws stay deterministic
+    void QueryFrustum(const Camera& camera, std::vector<SceneObjectId>& outIds) const;
+    void QueryFrustum(const Frustum& frustum, std::vector<SceneObjectId>& outIds) const;
+
+    // Objects whose bounds overlap the box, in insertion order
+    void QueryBox(const MeshBounds& box, std::vector<SceneObjectId>& outIds) const;
+
+    // Nearest object whose bounds the ray enters within maxDistance; picking is by bounds, not triangles
+    bool Raycast(const Vec3& origin, const Vec3& direction, float maxDistance, SceneRayHit& outHit) const;
+
+    // Levels of the tree, 0 when empty; stays near log2 of the object count
+    int GetTreeHeight() const;
+
+private:
+    static constexpr int NULL_NODE = -1;
+
+    struct Node
+    {
+        MeshBounds bounds;
+        int parent = NULL_NODE;
+        int child1 = NULL_NODE;
+        int child2 = NULL_NODE;
+        int height = 0; // 0 for a leaf
+        SceneObjectId object = 0;
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<RenderableObject> object;
+        int leaf = NULL_NODE;
+    };
+
+    const Entry& _GetEntry(SceneObjectId id) const;
+    static MeshBounds _ComputeObjectBounds(const RenderableObject& object);
+
+    int _AllocateNode();
+    void _FreeNode(int index);
+    void _InsertLeaf(int leaf);
+    void _RemoveLeaf(int leaf);
+    int _Balance(int index);
+    void _RefitAncestors(int index);
+
+    // Appends the objects of every leaf under index
+    void _CollectLeaves(int index, std::vector<SceneObjectId>& outIds) const;
+
+    std::vector<Entry> _entries; // Indexed by id, removed objects leave a null entry
+    size_t _objectCount = 0;
+
+    std::vector<Node> _nodes;
+    int _freeNode = NULL_NODE; // Free nodes are chained through their parent index
+    int _root = NULL_NODE;
+};
\ No newline at end of file
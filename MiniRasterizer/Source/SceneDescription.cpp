@@ -0,0 +1,258 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "SceneDescription.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <map>
+
+#include "MeshGenerator.h"
+#include "MeshFile.h"
+#include "MeshQuantization.h"
+#include "ShaderBlinnPhong.h"
+#include "ShaderToon.h"
+
+void SceneDescription::ParseDirective(const std::string& line)
+{
+    std::string content = line.substr(0, line.find('#'));
+    std::istringstream stream(content);
+
+    std::string directive;
+    if (!(stream >> directive))
+    {
+        return; // Blank line or comment
+    }
+
+    bool isValid = true;
+    if (directive == "resolution")
+    {
+        isValid = static_cast<bool>(stream >> width >> height) && width > 0 && height > 0;
+    }
+    else if (directive == "camera")
+    {
+        isValid = static_cast<bool>(stream >> cameraPosition.x >> cameraPosition.y >> cameraPosition.z);
+        float fov;
+        if (isValid && stream >> fov)
+        {
+            cameraFov = fov;
+        }
+    }
+    else if (directive == "light")
+    {
+        isValid = static_cast<bool>(stream >> light.position.x >> light.position.y >> light.position.z);
+        Vec3 color;
+        if (isValid && stream >> color.x >> color.y >> color.z)
+        {
+            light.color = color;
+        }
+    }
+    else if (directive == "sphere" || directive == "mesh")
+    {
+        SphereDescription sphere;
+        if (directive == "sphere")
+        {
+            isValid = static_cast<bool>(stream >> sphere.radius >> sphere.segments);
+        }
+        else
+        {
+            isValid = static_cast<bool>(stream >> sphere.meshPath);
+        }
+        isValid = isValid && static_cast<bool>(stream >> sphere.position.x >> sphere.position.y >> sphere.position.z
+            >> sphere.shaderName);
+
+        std::string assignment;
+        while (isValid && stream >> assignment)
+        {
+            size_t separator = assignment.find('=');
+            if (separator == std::string::npos)
+            {
+                isValid = false;
+                break;
+            }
+            std::string name = assignment.substr(0, separator);
+            std::string value = assignment.substr(separator + 1);
+            if (name == "ShadingRate")
+            {
+                if (value == "1x1") { sphere.shadingRate = ShadingRate::Rate1x1; }
+                else if (value == "1x2") { sphere.shadingRate = ShadingRate::Rate1x2; }
+                else if (value == "2x2") { sphere.shadingRate = ShadingRate::Rate2x2; }
+                else if (value == "4x4") { sphere.shadingRate = ShadingRate::Rate4x4; }
+                else { isValid = false; break; }
+                continue;
+            }
+            if (name == "Texture")
+            {
+                sphere.texture = value;
+                continue;
+            }
+            if (name == "TextureFilter")
+            {
+                if (value == "nearest") { sphere.textureFilter = TextureFilter::Nearest; }
+                else if (value == "bilinear") { sphere.textureFilter = TextureFilter::Bilinear; }
+                else if (value == "trilinear") { sphere.textureFilter = TextureFilter::Trilinear; }
+                else { isValid = false; break; }
+                continue;
+            }
+            if (name == "Vertices")
+            {
+                if (value == "float") { sphere.isQuantized = false; }
+                else if (value == "quantized") { sphere.isQuantized = true; }
+                else { isValid = false; break; }
+                continue;
+            }
+
+            // The whole value must be a number, like every other field
+            std::istringstream valueStream(value);
+            float number = 0.0f;
+            if (!(valueStream >> number) || !(valueStream >> std::ws).eof())
+            {
+                isValid = false;
+                break;
+            }
+            sphere.properties.emplace_back(name, number);
+        }
+
+        if (isValid)
+        {
+            spheres.push_back(sphere);
+        }
+    }
+    else
+    {
+        throw std::runtime_error("SceneDescription: Unknown directive '" + directive + "'.");
+    }
+
+    if (!isValid)
+    {
+        throw std::runtime_error("SceneDescription: Malformed directive '" + content + "'.");
+    }
+}
+
+void SceneDescription::LoadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("SceneDescription: Cannot open scene file '" + path + "'.");
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        try
+        {
+            ParseDirective(line);
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+}
+
+void SceneDescription::AddDefaultSphere()
+{
+    spheres.push_back(SphereDescription());
+}
+
+Camera SceneDescription::CreateCamera() const
+{
+    return Camera(
+        cameraPosition,
+        Vec3(0.0f, 0.0f, -1.0f),
+        cameraFov,
+        static_cast<float>(width) / height
+    );
+}
+
+std::shared_ptr<IShader> CreateShaderByName(const std::string& shaderName)
+{
+    if (shaderName == "blinnphong")
+    {
+        return std::make_shared<ShaderBlinnPhong>();
+    }
+    if (shaderName == "toon")
+    {
+        return std::make_shared<ShaderToon>();
+    }
+    throw std::runtime_error("Unknown shader '" + shaderName + "', expected blinnphong or toon.");
+}
+
+LoadedScene BuildScene(const SceneDescription& description)
+{
+    LoadedScene scene;
+    std::map<std::string, std::shared_ptr<IShader>> shaders;
+    std::map<std::pair<float, unsigned int>, std::shared_ptr<MeshData>> meshes;
+    std::map<std::string, std::shared_ptr<MeshData>> meshFiles;
+    std::map<const MeshData*, std::shared_ptr<MeshData>> quantizedMeshes;
+    std::map<std::string, std::shared_ptr<Texture>> textures;
+
+    for (const SphereDescription& sphere : description.spheres)
+    {
+        std::shared_ptr<IShader>& shader = shaders[sphere.shaderName];
+        if (!shader)
+        {
+            shader = CreateShaderByName(sphere.shaderName);
+            scene.shaders.push_back(shader);
+        }
+
+        std::shared_ptr<MeshData>& mesh = sphere.meshPath.empty()
+            ? meshes[{ sphere.radius, sphere.segments }]
+            : meshFiles[sphere.meshPath];
+        if (!mesh && sphere.meshPath.empty())
+        {
+            mesh = MeshGenerator::CreateSphere(sphere.radius, sphere.segments, Vec3(0, 0, 0));
+        }
+        else if (!mesh)
+        {
+            bool isOBJ = sphere.meshPath.size() >= 4 && sphere.meshPath.compare(sphere.meshPath.size() - 4, 4, ".obj") == 0;
+            mesh = isOBJ ? MeshFile::ImportOBJ(sphere.meshPath) : MeshFile::Load(sphere.meshPath);
+        }
+        std::shared_ptr<MeshData> drawnMesh = mesh;
+        if (sphere.isQuantized)
+        {
+            std::shared_ptr<MeshData>& quantized = quantizedMeshes[mesh.get()];
+            if (!quantized)
+            {
+                quantized = MeshQuantization::Quantize(*mesh);
+            }
+            drawnMesh = quantized;
+        }
+
+        auto material = std::make_shared<Material>(shader);
+        IShaderProperties* properties = material->GetProperties();
+        for (const auto& property : sphere.properties)
+        {
+            int index = properties->FindProperty(property.first);
+            if (index < 0)
+            {
+                throw std::runtime_error("Shader '" + sphere.shaderName + "' has no property '" + property.first + "'.");
+            }
+            properties->SetProperty(index, property.second);
+        }
+        material->SetShadingRate(sphere.shadingRate);
+
+        if (!sphere.texture.empty())
+        {
+            std::shared_ptr<Texture>& texture = textures[sphere.texture];
+            if (!texture)
+            {
+                texture = (sphere.texture == "checker")
+                    ? Texture::CreateCheckerboard(256, 8, Vec3(1.0f, 1.0f, 1.0f), Vec3(0.2f, 0.2f, 0.2f))
+                    : Texture::LoadPPM(sphere.texture);
+                scene.textures.push_back(texture);
+            }
+            material->GetProperties()->SetBaseColorTexture(texture, sphere.textureFilter);
+        }
+        scene.materials.push_back(material);
+
+        scene.objects.push_back(std::make_shared<RenderableObject>(drawnMesh, material, sphere.position));
+    }
+
+    return scene;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "Vec3.h"
+#include "Camera.h"
+#include "Light.h"
+#include "IShader.h"
+#include "Material.h"
+#include "RenderableObject.h"
+
+// A scene in plain data, as read from a scene file or the command line.
+//
+// Scene files hold one directive per line, '#' starts a comment:
+//   resolution <width> <height>
+//   camera <x> <y> <z> [fov]
+//   light <x> <y> <z> [r g b]
+//   sphere <radius> <segments> <x> <y> <z> <blinnphong|toon> [PropertyName=value ...] [ShadingRate=1x1|1x2|2x2|4x4]
+//          [Texture=checker|<file.ppm>] [TextureFilter=nearest|bilinear|trilinear] [Vertices=float|quantized]
+//   mesh <file.mrmesh|file.obj> <x> <y> <z> <blinnphong|toon> [same options as sphere]
+struct SphereDescription
+{
+    float radius = 3.0f;
+    unsigned int segments = 64;
+    std::string meshPath; // A mesh directive: the file replaces the generated sphere
+    Vec3 position;
+    std::string shaderName = "blinnphong";
+    std::vector<std::pair<std::string, float>> properties;
+    ShadingRate shadingRate = ShadingRate::Rate1x1;
+    std::string texture; // Empty for none
+    TextureFilter textureFilter = TextureFilter::Trilinear;
+    bool isQuantized = false; // Draw from compressed vertex streams, see MeshQuantization
+};
+
+struct SceneDescription
+{
+    int width = 1080;
+    int height = 720;
+    Vec3 cameraPosition{ 0.0f, 0.0f, 10.0f };
+    float cameraFov = 60.0f;
+    Light light{ Vec3(-10.0f, 10.0f, 10.0f), Vec3(1.0f, 1.0f, 1.0f) };
+    std::vector<SphereDescription> spheres;
+
+    // Throws std::runtime_error naming the offending directive
+    void ParseDirective(const std::string& line);
+    void LoadFile(const std::string& path);
+
+    // Same sphere as the MaterialPreviewer start-up scene
+    void AddDefaultSphere();
+
+    Camera CreateCamera() const;
+};
+
+// Owns everything a scene needs to be drawn
+struct LoadedScene
+{
+    std::vector<std::shared_ptr<IShader>> shaders;
+    std::vector<std::shared_ptr<Material>> materials;
+    std::vector<std::shared_ptr<Texture>> textures;
+    std::vector<std::shared_ptr<RenderableObject>> objects;
+};
+
+// Meshes, shaders and textures are shared between spheres that use the same settings
+LoadedScene BuildScene(const SceneDescription& description);
+
+// Accepts "blinnphong" or "toon", throws std::runtime_error otherwise
+std::shared_ptr<IShader> CreateShaderByName(const std::string& shaderName);
\ No newline at end of file
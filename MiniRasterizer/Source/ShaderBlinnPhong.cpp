@@ -9,20 +9,31 @@
 #include <algorithm>
 #include <cmath>
 
-VertexOutput ShaderBlinnPhong::RunVertexShader(
+WorldVertex ShaderBlinnPhong::RunWorldStage(
     const VertexInput& input,
-    const Camera& camera,
     const Vec3& objectPosition
 ) const
 {
     // 1. Model-to-World Transform
     // We are calling our simplified Vec3-based function.
-    Vec3 worldPos = ShaderUtils::TransformModelToWorld(input.positionMS, objectPosition);
+    WorldVertex output;
+    output.positionWS = ShaderUtils::TransformModelToWorld(input.positionMS, objectPosition);
 
     // [SIMPLIFICATION]
     // A normal vector (a direction) should be transformed differently than a position. It should use the inverse-transpose of the model matrix and 'w' component should be 0.
     // For now, we assume no rotation/scale, so we just pass it along.
-    Vec3 normalWS = input.normalMS;
+    output.normalWS = input.normalMS;
+    output.uv = input.uv;
+    return output;
+}
+
+VertexOutput ShaderBlinnPhong::RunViewStage(
+    const WorldVertex& vertex,
+    const Camera& camera
+) const
+{
+    const Vec3& worldPos = vertex.positionWS;
+    const Vec3& normalWS = vertex.normalWS;
 
     // 2. World-to-View Transform
     // Calling our simplified Vec3-based function.
@@ -41,6 +52,7 @@ VertexOutput ShaderBlinnPhong::RunVertexShader(
     Varyings varyings;
     varyings.positionVS = viewPos;
     varyings.normalVS = normalVS;
+    varyings.uv = vertex.uv;
 
     // The final output MUST be a VertexOutput containing the Vec4 clipPos
     return VertexOutput{ clipPos, varyings };
@@ -72,7 +84,7 @@ Vec3 ShaderBlinnPhong::RunFragmentShader(
     float NdotH = std::max(0.0f, N.dot(H));
 
     Vec3 ambient = props.ambient;
-    Vec3 diffuse = props.diffuse * NdotL;
+    Vec3 diffuse = props.diffuse * ShaderUtils::SampleBaseColorTexture(props, fragment) * NdotL;
     Vec3 specular = props.specular * std::pow(NdotH, props.smoothness);
 
     Vec3 finalColor = (ambient + diffuse + specular) * light.color;
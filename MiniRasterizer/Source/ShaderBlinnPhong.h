@@ -9,12 +9,16 @@
 class ShaderBlinnPhong : public IShader
 {
 public:
-    virtual VertexOutput RunVertexShader(
+    virtual WorldVertex RunWorldStage(
         const VertexInput& input,
-        const Camera& camera,
         const Vec3& objectPosition
     ) const override;
 
+    virtual VertexOutput RunViewStage(
+        const WorldVertex& vertex,
+        const Camera& camera
+    ) const override;
+
     virtual Vec3 RunFragmentShader(
         const Fragment& fragment,
         const Camera& camera,
@@ -9,22 +9,32 @@
 #include <algorithm>
 #include <cmath>
 
-VertexOutput ShaderToon::RunVertexShader(
+WorldVertex ShaderToon::RunWorldStage(
     const VertexInput& input,
-    const Camera& camera,
     const Vec3& objectPosition
 ) const
 {
-    Vec3 worldPos = ShaderUtils::TransformModelToWorld(input.positionMS, objectPosition);
-    Vec3 normalWS = input.normalMS;
-    Vec3 viewPos = ShaderUtils::TransformWorldToView(worldPos, camera);
-    Vec3 normalVS = ShaderUtils::TransformWorldToView(normalWS + worldPos, camera) - viewPos;
+    WorldVertex output;
+    output.positionWS = ShaderUtils::TransformModelToWorld(input.positionMS, objectPosition);
+    output.normalWS = input.normalMS;
+    output.uv = input.uv;
+    return output;
+}
+
+VertexOutput ShaderToon::RunViewStage(
+    const WorldVertex& vertex,
+    const Camera& camera
+) const
+{
+    Vec3 viewPos = ShaderUtils::TransformWorldToView(vertex.positionWS, camera);
+    Vec3 normalVS = ShaderUtils::TransformWorldToView(vertex.normalWS + vertex.positionWS, camera) - viewPos;
     normalVS = normalVS.normalize();
     Vec4 clipPos = ShaderUtils::TransformViewToClip(viewPos, camera);
 
     Varyings varyings;
     varyings.positionVS = viewPos;
     varyings.normalVS = normalVS;
+    varyings.uv = vertex.uv;
 
     return VertexOutput{ clipPos, varyings };
 }
@@ -75,7 +85,7 @@ Vec3 ShaderToon::RunFragmentShader(
         rimThreshold + props.rimSoftness,
         finalRimFactor);
 
-    Vec3 base = props.ambient + props.baseColor * toonDiffuse;
+    Vec3 base = props.ambient + props.baseColor * ShaderUtils::SampleBaseColorTexture(props, fragment) * toonDiffuse;
     Vec3 fragColor = base * (1.0f - rimAmount) + props.rimColor * rimAmount;
     fragColor = fragColor * light.color;
 
@@ -7,6 +7,8 @@
 #include "Vec3.h"
 #include "Vec4.h"
 #include "Camera.h"
+#include "PipelineData.h"
+#include "IShaderProperties.h"
 #include <cmath>
 #include <algorithm>
 
@@ -64,6 +66,17 @@ namespace ShaderUtils
         return Vec4(x, y, z, w);
     }
 
+    // The material's base color texture at the fragment, white when it has none
+    inline Vec3 SampleBaseColorTexture(const IShaderProperties& properties, const Fragment& fragment)
+    {
+        const Texture* texture = properties.GetBaseColorTexture();
+        if (!texture)
+        {
+            return Vec3(1.0f, 1.0f, 1.0f);
+        }
+        return texture->Sample(fragment.interpolatedVaryings.uv, fragment.uvDdx, fragment.uvDdy, properties.GetBaseColorFilter());
+    }
+
     inline float Smoothstep(float edge0, float edge1, float x)
     {
         x = std::max(0.0f, std::min(1.0f, (x - edge0) / (edge1 - edge0)));
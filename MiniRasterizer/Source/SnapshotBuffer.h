@@ -0,0 +1,54 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value of T from one writer thread to one reader thread without locks (triple buffering).
+// The writer fills its private slot and publishes it; the reader takes the newest published slot.
+// Neither side ever waits, intermediate values the reader did not pick up are simply skipped.
+template <typename T>
+class SnapshotBuffer
+{
+public:
+    // Writer: the slot to fill completely before Publish(), its old content is a stale snapshot
+    T& GetWriteSlot()
+    {
+        return _slots[_writeIndex];
+    }
+
+    void Publish()
+    {
+        uint8_t previous = _sharedIndex.exchange(static_cast<uint8_t>(_writeIndex | FRESH_BIT), std::memory_order_acq_rel);
+        _writeIndex = previous & INDEX_MASK;
+    }
+
+    // Reader: returns true and switches GetReadSlot() to the newest snapshot if one was published since the last call
+    bool Acquire()
+    {
+        if ((_sharedIndex.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+        {
+            return false;
+        }
+        uint8_t previous = _sharedIndex.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& GetReadSlot() const
+    {
+        return _slots[_readIndex];
+    }
+
+private:
+    static constexpr uint8_t FRESH_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    T _slots[3];
+    uint8_t _writeIndex = 0;
+    std::atomic<uint8_t> _sharedIndex{ 1 };
+    uint8_t _readIndex = 2;
+};
\ No newline at end of file
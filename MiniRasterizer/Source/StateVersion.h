@@ -0,0 +1,17 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Every state change takes a fresh number from one process-wide counter.
+// Versions are therefore unique across objects as well as over time, so comparing versions is enough
+// to know that nothing changed, and the newest of several versions is simply the largest.
+inline uint64_t NextStateVersion()
+{
+    static std::atomic<uint64_t> counter{ 0 };
+    return ++counter;
+}
\ No newline at end of file
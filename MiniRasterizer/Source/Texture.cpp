@@ -0,0 +1,307 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "Texture.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    bool IsPowerOfTwo(int value)
+    {
+        return value > 0 && (value & (value - 1)) == 0;
+    }
+
+    // Interleaves the bits of a 3-bit x and y (0..7) into a 6-bit Z-order index
+    int MortonEncode(int x, int y)
+    {
+        static constexpr uint8_t spread[Texture::TILE_SIZE] = { 0, 1, 4, 5, 16, 17, 20, 21 };
+        return spread[x] | (spread[y] << 1);
+    }
+
+    // Filter weights are 8-bit fixed point like in hardware texture units, so a blend fits 32-bit integer math
+    constexpr int FILTER_WEIGHT_BITS = 8;
+    constexpr uint32_t FILTER_WEIGHT_ONE = 1u << FILTER_WEIGHT_BITS;
+
+    // Weighted sum of two packed RGBA8 texels, weights add up to FILTER_WEIGHT_ONE.
+    // Red/blue and green/alpha are blended as two 16-bit lanes per register (SIMD within a register).
+    uint32_t BlendTexels(uint32_t a, uint32_t weightA, uint32_t b, uint32_t weightB)
+    {
+        uint32_t redBlue = ((a & 0x00FF00FFu) * weightA + (b & 0x00FF00FFu) * weightB) >> FILTER_WEIGHT_BITS;
+        uint32_t greenAlpha = ((a >> 8) & 0x00FF00FFu) * weightA + ((b >> 8) & 0x00FF00FFu) * weightB;
+        return (redBlue & 0x00FF00FFu) | (greenAlpha & 0xFF00FF00u);
+    }
+
+    Vec3 UnpackRGB(uint32_t texel)
+    {
+        return Vec3(
+            static_cast<float>(texel & 0xFF),
+            static_cast<float>((texel >> 8) & 0xFF),
+            static_cast<float>((texel >> 16) & 0xFF)) * (1.0f / 255.0f);
+    }
+
+    // Exponent plus linear mantissa, exact at powers of two and within 0.09 elsewhere; enough to pick a mip level
+    float ApproximateLog2(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<float>(bits) * (1.0f / (1 << 23)) - 127.0f;
+    }
+
+    // Avoids the library call std::floor compiles to without SSE4.1
+    int FloorToInt(float value)
+    {
+        int truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+    }
+
+    uint32_t PackRGBA8(const Vec3& color)
+    {
+        auto toByte = [](float c)
+        {
+            return static_cast<uint32_t>(std::min(1.0f, std::max(0.0f, c)) * 255.0f + 0.5f);
+        };
+        return toByte(color.x) | (toByte(color.y) << 8) | (toByte(color.z) << 16) | 0xFF000000u;
+    }
+
+    // Skips whitespace and '#' comments between PPM header fields
+    void SkipPPMSeparators(std::istream& stream)
+    {
+        while (stream)
+        {
+            int c = stream.peek();
+            if (c == '#')
+            {
+                std::string comment;
+                std::getline(stream, comment);
+            }
+            else if (std::isspace(c))
+            {
+                stream.get();
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+}
+
+Texture::Texture(int width, int height, const std::vector<Vec3>& texels)
+{
+    if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height))
+    {
+        throw std::runtime_error("Texture: Size must be a power of two, got " +
+            std::to_string(width) + "x" + std::to_string(height) + ".");
+    }
+    if (texels.size() != static_cast<size_t>(width) * height)
+    {
+        throw std::runtime_error("Texture: Texel count does not match the size.");
+    }
+
+    // Each level is a 2x2 box filter of the previous one, down to 1x1
+    _AddLevel(width, height, texels);
+    std::vector<Vec3> previous = texels;
+    while (width > 1 || height > 1)
+    {
+        int nextWidth = std::max(1, width / 2);
+        int nextHeight = std::max(1, height / 2);
+        std::vector<Vec3> next(static_cast<size_t>(nextWidth) * nextHeight);
+        for (int y = 0; y < nextHeight; ++y)
+        {
+            int y0 = std::min(y * 2, height - 1);
+            int y1 = std::min(y * 2 + 1, height - 1);
+            for (int x = 0; x < nextWidth; ++x)
+            {
+                int x0 = std::min(x * 2, width - 1);
+                int x1 = std::min(x * 2 + 1, width - 1);
+                next[y * nextWidth + x] = (previous[y0 * width + x0] + previous[y0 * width + x1] +
+                    previous[y1 * width + x0] + previous[y1 * width + x1]) * 0.25f;
+            }
+        }
+        width = nextWidth;
+        height = nextHeight;
+        _AddLevel(width, height, next);
+        previous = std::move(next);
+    }
+}
+
+std::shared_ptr<Texture> Texture::LoadPPM(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Texture: Failed to open '" + path + "'.");
+    }
+
+    std::string magic;
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+    file >> magic;
+    SkipPPMSeparators(file);
+    file >> width;
+    SkipPPMSeparators(file);
+    file >> height;
+    SkipPPMSeparators(file);
+    file >> maxValue;
+    file.get(); // Single whitespace before the raster
+    if (!file || magic != "P6" || width <= 0 || height <= 0 || maxValue != 255)
+    {
+        throw std::runtime_error("Texture: '" + path + "' is not an 8-bit binary PPM (P6).");
+    }
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(width) * height * 3);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    if (!file)
+    {
+        throw std::runtime_error("Texture: '" + path + "' ends before its pixel data.");
+    }
+
+    std::vector<Vec3> texels(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < texels.size(); ++i)
+    {
+        texels[i] = Vec3(bytes[i * 3], bytes[i * 3 + 1], bytes[i * 3 + 2]) * (1.0f / 255.0f);
+    }
+    return std::make_shared<Texture>(width, height, texels);
+}
+
+std::shared_ptr<Texture> Texture::CreateCheckerboard(int size, int cellCount, const Vec3& colorA, const Vec3& colorB)
+{
+    int cellSize = std::max(1, size / std::max(1, cellCount));
+    std::vector<Vec3> texels(static_cast<size_t>(size) * size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            texels[y * size + x] = ((x / cellSize + y / cellSize) % 2 == 0) ? colorA : colorB;
+        }
+    }
+    return std::make_shared<Texture>(size, size, texels);
+}
+
+Vec3 Texture::SampleLevel(const Vec2& uv, float level, TextureFilter filter) const
+{
+    float maxLevel = static_cast<float>(_levels.size() - 1);
+    level = std::min(maxLevel, std::max(0.0f, level));
+
+    uint32_t texel;
+    if (filter == TextureFilter::Nearest)
+    {
+        texel = _SampleNearest(_levels[static_cast<int>(level + 0.5f)], uv);
+    }
+    else if (filter == TextureFilter::Bilinear)
+    {
+        texel = _SampleBilinear(_levels[static_cast<int>(level + 0.5f)], uv);
+    }
+    else
+    {
+        int lowerLevel = static_cast<int>(level);
+        uint32_t blend = static_cast<uint32_t>((level - lowerLevel) * FILTER_WEIGHT_ONE);
+        texel = _SampleBilinear(_levels[lowerLevel], uv);
+        if (blend > 0)
+        {
+            uint32_t upper = _SampleBilinear(_levels[lowerLevel + 1], uv);
+            texel = BlendTexels(texel, FILTER_WEIGHT_ONE - blend, upper, blend);
+        }
+    }
+    return UnpackRGB(texel);
+}
+
+float Texture::ComputeLevel(const Vec2& uvDdx, const Vec2& uvDdy) const
+{
+    float width = static_cast<float>(_levels[0].width);
+    float height = static_cast<float>(_levels[0].height);
+    Vec2 texelDdx(uvDdx.x * width, uvDdx.y * height);
+    Vec2 texelDdy(uvDdy.x * width, uvDdy.y * height);
+    float footprintSquared = std::max(texelDdx.dot(texelDdx), texelDdy.dot(texelDdy));
+    if (!(footprintSquared > 1.0f))
+    {
+        return 0.0f; // Magnified
+    }
+    // log2(sqrt(f)) without the square root
+    float level = 0.5f * ApproximateLog2(footprintSquared);
+    return std::min(level, static_cast<float>(_levels.size() - 1));
+}
+
+void Texture::_AddLevel(int width, int height, const std::vector<Vec3>& texels)
+{
+    MipLevel level;
+    level.width = width;
+    level.height = height;
+    level.tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    level.offset = _texels.size();
+
+    // Levels under 8x8 still take one whole tile
+    int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    _texels.resize(_texels.size() + static_cast<size_t>(level.tilesX) * tilesY * TILE_TEXEL_COUNT, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int tileIndex = (y >> 3) * level.tilesX + (x >> 3);
+            _texels[level.offset + ((tileIndex << 6) | MortonEncode(x & 7, y & 7))] = PackRGBA8(texels[y * width + x]);
+        }
+    }
+    _levels.push_back(level);
+}
+
+uint32_t Texture::_Fetch(const MipLevel& level, int x, int y) const
+{
+    // Power-of-two sizes make repeat a mask, which also handles negative coordinates
+    x &= level.width - 1;
+    y &= level.height - 1;
+    int tileIndex = (y >> 3) * level.tilesX + (x >> 3);
+    return _texels[level.offset + ((tileIndex << 6) | MortonEncode(x & 7, y & 7))];
+}
+
+uint32_t Texture::_SampleNearest(const MipLevel& level, const Vec2& uv) const
+{
+    int x = FloorToInt(uv.x * level.width);
+    int y = FloorToInt(uv.y * level.height);
+    return _Fetch(level, x, y);
+}
+
+uint32_t Texture::_SampleBilinear(const MipLevel& level, const Vec2& uv) const
+{
+    // Texel centers sit at half-integer coordinates. One floor in fixed point gives both the texel and the weight.
+    int fx = FloorToInt((uv.x * level.width - 0.5f) * FILTER_WEIGHT_ONE);
+    int fy = FloorToInt((uv.y * level.height - 0.5f) * FILTER_WEIGHT_ONE);
+    int x = fx >> FILTER_WEIGHT_BITS;
+    int y = fy >> FILTER_WEIGHT_BITS;
+    uint32_t tx = static_cast<uint32_t>(fx) & (FILTER_WEIGHT_ONE - 1);
+    uint32_t ty = static_cast<uint32_t>(fy) & (FILTER_WEIGHT_ONE - 1);
+
+    uint32_t taps[4];
+    x &= level.width - 1;
+    y &= level.height - 1;
+    int tileX = x & (TILE_SIZE - 1);
+    int tileY = y & (TILE_SIZE - 1);
+    if (tileX != TILE_SIZE - 1 && tileY != TILE_SIZE - 1 && x + 1 < level.width && y + 1 < level.height)
+    {
+        // The whole 2x2 footprint is inside one tile, so its address is computed once
+        const uint32_t* tile = &_texels[level.offset + (static_cast<size_t>((y >> 3) * level.tilesX + (x >> 3)) << 6)];
+        taps[0] = tile[MortonEncode(tileX, tileY)];
+        taps[1] = tile[MortonEncode(tileX + 1, tileY)];
+        taps[2] = tile[MortonEncode(tileX, tileY + 1)];
+        taps[3] = tile[MortonEncode(tileX + 1, tileY + 1)];
+    }
+    else
+    {
+        taps[0] = _Fetch(level, x, y);
+        taps[1] = _Fetch(level, x + 1, y);
+        taps[2] = _Fetch(level, x, y + 1);
+        taps[3] = _Fetch(level, x + 1, y + 1);
+    }
+
+    uint32_t top = BlendTexels(taps[0], FILTER_WEIGHT_ONE - tx, taps[1], tx);
+    uint32_t bottom = BlendTexels(taps[2], FILTER_WEIGHT_ONE - tx, taps[3], tx);
+    return BlendTexels(top, FILTER_WEIGHT_ONE - ty, bottom, ty);
+}
\ No newline at end of file
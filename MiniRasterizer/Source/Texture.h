@@ -0,0 +1,80 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "Vec2.h"
+#include "Vec3.h"
+#include "StateVersion.h"
+
+enum class TextureFilter
+{
+    Nearest,  // One texel of the nearest mip level
+    Bilinear, // 2x2 texels of the nearest mip level
+    Trilinear // Bilinear on the two mip levels around the footprint, blended
+};
+
+// Immutable RGB texture with a full mip chain, repeated in both directions.
+// Every level is stored as 8-bit RGBA in 8x8 texel tiles, Morton (Z-order) inside each tile like the tiled
+// FrameBuffer, so the 2x2 footprint of a bilinear tap nearly always sits in one 256-byte tile.
+// The level is picked from the screen-space UV derivatives: a minified texture reads a small level that stays
+// in cache instead of striding across the full-size one.
+class Texture
+{
+public:
+    static constexpr int TILE_SIZE = 8;
+    static constexpr int TILE_TEXEL_COUNT = TILE_SIZE * TILE_SIZE;
+
+    // Row-major texels with components in [0, 1]. Width and height must be powers of two.
+    Texture(int width, int height, const std::vector<Vec3>& texels);
+
+    // Binary PPM (P6) with a maxval of 255, as written by ImageWriter
+    static std::shared_ptr<Texture> LoadPPM(const std::string& path);
+    static std::shared_ptr<Texture> CreateCheckerboard(int size, int cellCount, const Vec3& colorA, const Vec3& colorB);
+
+    // uvDdx and uvDdy are the UV derivatives per screen pixel, see Fragment
+    Vec3 Sample(const Vec2& uv, const Vec2& uvDdx, const Vec2& uvDdy, TextureFilter filter) const
+    {
+        return SampleLevel(uv, ComputeLevel(uvDdx, uvDdy), filter);
+    }
+
+    Vec3 SampleLevel(const Vec2& uv, float level, TextureFilter filter) const;
+
+    // log2 of the number of level 0 texels one pixel covers along its longer axis, clamped to the chain
+    float ComputeLevel(const Vec2& uvDdx, const Vec2& uvDdy) const;
+
+    int GetWidth() const { return _levels[0].width; }
+    int GetHeight() const { return _levels[0].height; }
+    int GetLevelCount() const { return static_cast<int>(_levels.size()); }
+
+    // Textures are immutable, so this doubles as an identity
+    uint64_t GetVersion() const { return _version; }
+
+private:
+    struct MipLevel
+    {
+        int width;
+        int height;
+        int tilesX;
+        size_t offset; // First texel of the level in _texels
+    };
+
+    void _AddLevel(int width, int height, const std::vector<Vec3>& texels);
+
+    // Packed RGBA8 texel, the coordinates wrap
+    uint32_t _Fetch(const MipLevel& level, int x, int y) const;
+
+    uint32_t _SampleNearest(const MipLevel& level, const Vec2& uv) const;
+    uint32_t _SampleBilinear(const MipLevel& level, const Vec2& uv) const;
+
+    std::vector<MipLevel> _levels;
+    std::vector<uint32_t> _texels;
+    uint64_t _version = NextStateVersion();
+};
\ No newline at end of file
@@ -7,8 +7,6 @@
 #include "IShaderProperties.h"
 #include "Vec3.h"
 #include <string>
-#include <map>
-#include <utility>
 
 struct ToonProperties : public IShaderProperties
 {
@@ -20,24 +18,25 @@ struct ToonProperties : public IShaderProperties
     float rimSoftness{ 0.1f };
     float rimDirection{ 1.0f };
 
-    std::map<std::string, std::pair<float, float>> GetSliderProperties() const override
+    ArrayView<ShaderPropertyDescriptor> GetPropertyDescriptors() const override
     {
-        return
+        static constexpr ShaderPropertyDescriptor DESCRIPTORS[] =
         {
-            {"AmbientX_Red", {0.0f, 1.0f}},
-            {"AmbientY_Green", {0.0f, 1.0f}},
-            {"AmbientZ_Blue", {0.0f, 1.0f}},
-            {"BaseColorX_Red", {0.0f, 1.0f}},
-            {"BaseColorY_Green", {0.0f, 1.0f}},
-            {"BaseColorZ_Blue", {0.0f, 1.0f}},
-            {"DiffuseSoftness", {0.01f, 0.5f}},
-            {"RimColorX_Red", {0.0f, 1.0f}},
-            {"RimColorY_Green", {0.0f, 1.0f}},
-            {"RimColorZ_Blue", {0.0f, 1.0f}},
-            {"RimWidth", {0.0f, 1.0f}},
-            {"RimSoftness", {0.01f, 0.5f}},
-            {"RimDirection", {-1.0f, 1.0f}}
+            _VectorProperty("AmbientX_Red", 0.0f, 1.0f, &ToonProperties::ambient, &Vec3::x),
+            _VectorProperty("AmbientY_Green", 0.0f, 1.0f, &ToonProperties::ambient, &Vec3::y),
+            _VectorProperty("AmbientZ_Blue", 0.0f, 1.0f, &ToonProperties::ambient, &Vec3::z),
+            _VectorProperty("BaseColorX_Red", 0.0f, 1.0f, &ToonProperties::baseColor, &Vec3::x),
+            _VectorProperty("BaseColorY_Green", 0.0f, 1.0f, &ToonProperties::baseColor, &Vec3::y),
+            _VectorProperty("BaseColorZ_Blue", 0.0f, 1.0f, &ToonProperties::baseColor, &Vec3::z),
+            _FloatProperty("DiffuseSoftness", 0.01f, 0.5f, &ToonProperties::softness),
+            _VectorProperty("RimColorX_Red", 0.0f, 1.0f, &ToonProperties::rimColor, &Vec3::x),
+            _VectorProperty("RimColorY_Green", 0.0f, 1.0f, &ToonProperties::rimColor, &Vec3::y),
+            _VectorProperty("RimColorZ_Blue", 0.0f, 1.0f, &ToonProperties::rimColor, &Vec3::z),
+            _FloatProperty("RimDirection", -1.0f, 1.0f, &ToonProperties::rimDirection),
+            _FloatProperty("RimSoftness", 0.01f, 0.5f, &ToonProperties::rimSoftness),
+            _FloatProperty("RimWidth", 0.0f, 1.0f, &ToonProperties::rimWidth)
         };
+        return { DESCRIPTORS, sizeof(DESCRIPTORS) / sizeof(DESCRIPTORS[0]) };
     }
 
     std::string GetShaderName() const override
@@ -0,0 +1,43 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <cmath>
+
+struct Vec2
+{
+public:
+    float x, y;
+    Vec2(float x = 0, float y = 0)
+        : x(x), y(y)
+    {
+    }
+
+    Vec2 operator*(const float& other) const
+    {
+        return Vec2(x * other, y * other);
+    }
+
+    Vec2 operator+(const Vec2& other) const
+    {
+        return Vec2(x + other.x, y + other.y);
+    }
+
+    Vec2 operator-(const Vec2& other) const
+    {
+        return Vec2(x - other.x, y - other.y);
+    }
+
+    float dot(const Vec2& other) const
+    {
+        return x * other.x + y * other.y;
+    }
+};
+
+
+inline Vec2 operator*(const float& other, const Vec2& vec)
+{
+    return vec * other;
+}
\ No newline at end of file
@@ -35,6 +35,16 @@ public:
         return Vec3(x - other.x, y - other.y, z - other.z);
     }
 
+    bool operator==(const Vec3& other) const
+    {
+        return x == other.x && y == other.y && z == other.z;
+    }
+
+    bool operator!=(const Vec3& other) const
+    {
+        return !(*this == other);
+    }
+
     float dot(const Vec3& other) const
     {
         return x * other.x + y * other.y + z * other.z;
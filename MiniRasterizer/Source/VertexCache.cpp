@@ -0,0 +1,109 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#include "VertexCache.h"
+#include "FrameHash.h"
+
+void VertexCache::SetBudget(size_t budgetBytes)
+{
+    _budgetBytes = budgetBytes;
+    _EvictToBudget();
+}
+
+const std::vector<TrianglePrimitive>* VertexCache::Find(const VertexCacheKey& key)
+{
+    auto it = _lookup.find(key);
+    if (it == _lookup.end())
+    {
+        _misses++;
+        return nullptr;
+    }
+
+    _hits++;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return &it->second->triangles;
+}
+
+void VertexCache::Insert(const VertexCacheKey& key, const TrianglePrimitive* triangles, size_t triangleCount)
+{
+    size_t bytes = sizeof(Entry) + triangleCount * sizeof(TrianglePrimitive);
+    if (bytes > _budgetBytes)
+    {
+        return;
+    }
+
+    auto existing = _lookup.find(key);
+    if (existing != _lookup.end())
+    {
+        _bytesUsed -= existing->second->bytes;
+        _entries.erase(existing->second);
+        _lookup.erase(existing);
+    }
+
+    _entries.push_front(Entry{ key, std::vector<TrianglePrimitive>(triangles, triangles + triangleCount), bytes });
+    _lookup[key] = _entries.begin();
+    _bytesUsed += bytes;
+
+    _EvictToBudget();
+}
+
+void VertexCache::Clear()
+{
+    _entries.clear();
+    _lookup.clear();
+    _bytesUsed = 0;
+}
+
+void VertexCache::ResetStats()
+{
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+VertexCacheStats VertexCache::GetStats() const
+{
+    VertexCacheStats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.evictions = _evictions;
+    stats.entryCount = _entries.size();
+    stats.bytesUsed = _bytesUsed;
+    stats.budgetBytes = _budgetBytes;
+    return stats;
+}
+
+namespace
+{
+    // -0 and +0 compare equal, so they must hash alike
+    float CanonicalZero(float value)
+    {
+        return value == 0.0f ? 0.0f : value;
+    }
+}
+
+size_t VertexCache::KeyHasher::operator()(const VertexCacheKey& key) const
+{
+    FrameHash hash;
+    hash.Add(key.meshVersion);
+    hash.Add(CanonicalZero(key.objectPosition.x));
+    hash.Add(CanonicalZero(key.objectPosition.y));
+    hash.Add(CanonicalZero(key.objectPosition.z));
+    hash.Add(key.cameraVersion);
+    hash.Add(static_cast<const void*>(key.shader));
+    return static_cast<size_t>(hash.GetValue());
+}
+
+void VertexCache::_EvictToBudget()
+{
+    while (_bytesUsed > _budgetBytes && !_entries.empty())
+    {
+        Entry& oldest = _entries.back();
+        _bytesUsed -= oldest.bytes;
+        _lookup.erase(oldest.key);
+        _entries.pop_back();
+        _evictions++;
+    }
+}
\ No newline at end of file
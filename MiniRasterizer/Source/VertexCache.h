@@ -0,0 +1,91 @@
+/* MiniRasterizer
+ * Copyright (c) 2025 terrytw. Licensed under the MIT License.
+ * See LICENSE file for details.
+ */
+
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "Vec3.h"
+#include "PipelineData.h"
+
+class IShader;
+
+// Everything the output of vertex and triangle processing depends on
+struct VertexCacheKey
+{
+    uint64_t meshVersion = 0;
+    Vec3 objectPosition; // Compared exactly, only hashed for bucketing
+    uint64_t cameraVersion = 0;
+    const IShader* shader = nullptr;
+
+    bool operator==(const VertexCacheKey& other) const
+    {
+        return meshVersion == other.meshVersion &&
+            objectPosition == other.objectPosition &&
+            cameraVersion == other.cameraVersion &&
+            shader == other.shader;
+    }
+};
+
+struct VertexCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entryCount = 0;
+    size_t bytesUsed = 0;
+    size_t budgetBytes = 0;
+};
+
+// Keeps the assembled triangles of recently drawn objects across frames, so an object whose mesh,
+// transform, camera and shader are unchanged skips vertex and triangle processing.
+// Each TrianglePrimitive embeds its three post-vertex-shader outputs, so one list serves both stages.
+// Entries are evicted least-recently-used first once the memory budget is exceeded.
+class VertexCache
+{
+public:
+    // A budget of 0 disables the cache
+    void SetBudget(size_t budgetBytes);
+    bool IsEnabled() const { return _budgetBytes > 0; }
+
+    // Returns nullptr on a miss; a hit marks the entry as most recently used
+    const std::vector<TrianglePrimitive>* Find(const VertexCacheKey& key);
+
+    // Entries larger than the whole budget are not stored
+    void Insert(const VertexCacheKey& key, const TrianglePrimitive* triangles, size_t triangleCount);
+
+    void Clear();
+    void ResetStats();
+    VertexCacheStats GetStats() const;
+
+private:
+    struct KeyHasher
+    {
+        size_t operator()(const VertexCacheKey& key) const;
+    };
+
+    struct Entry
+    {
+        VertexCacheKey key;
+        std::vector<TrianglePrimitive> triangles;
+        size_t bytes = 0;
+    };
+
+    void _EvictToBudget();
+
+    size_t _budgetBytes = 0;
+    size_t _bytesUsed = 0;
+
+    // Front is the most recently used entry
+    std::list<Entry> _entries;
+    std::unordered_map<VertexCacheKey, std::list<Entry>::iterator, KeyHasher> _lookup;
+
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
\ No newline at end of file
@@ -9,59 +9,99 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
-#include <map>
 #include <utility>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <exception>
 
 #include "Vec3.h"
 #include "Camera.h"
 #include "Light.h"
 #include "RenderPipeline.h"
 #include "RenderableObject.h"
+#include "Scene.h"
 #include "Material.h"
 #include "ShaderBlinnPhong.h"
 #include "ShaderToon.h"
 #include "BlinnPhongProperties.h"
 #include "ToonProperties.h"
 #include "MeshGenerator.h"
-#include "PropertyEnums.h"
 #include "Slider.h"
+#include "FrameHash.h"
+#include "Profiler.h"
+#include "SnapshotBuffer.h"
+
 
 static constexpr int SCREEN_WIDTH = 1080;
 static constexpr int SCREEN_HEIGHT = 720;
+static constexpr int IDLE_SLEEP_MS = 10;
+static constexpr size_t VERTEX_CACHE_BUDGET_BYTES = 64 * 1024 * 1024;
+static constexpr double TARGET_FRAME_MS = 16.0;
+static const char* TRACE_OUTPUT_PATH = "MiniRasterizer.trace.json";
+
+// Everything the render thread needs from the UI, handed over as one value
+struct PreviewerSnapshot
+{
+    size_t materialIndex = 0;
+    std::vector<float> shaderValues; // In GetPropertyDescriptors() order
+    ShadingRate shadingRate = ShadingRate::Rate1x1;
+    int sampleCount = 1;
+    PostProcessSettings postProcess;
+    Light light;
+};
 
 
 class MaterialPreviewer
 {
 private:
     sf::RenderWindow _window;
-    RenderPipeline _pipeline;
     sf::Texture _texture;
     sf::Sprite _sprite;
-    sf::Image _image; // Pipeline result will be export to SFML image
 
+    // ---- Render thread only (once Run() has started it) ----
+    RenderPipeline _pipeline;
     Camera _camera;
-    Light _light;
-
-    std::vector<std::shared_ptr<RenderableObject>> _scene;
-
+    Scene _scene;
+    SceneObjectId _previewObjectId = 0;
+    std::vector<SceneObjectId> _visibleObjects;
     std::vector<std::shared_ptr<IShader>> _availableShaders;
     std::vector<std::shared_ptr<Material>> _availableMaterials;
-    int _currentMaterialIndex = 0;
 
-    // UI
+    // ---- Shared between the threads ----
+    std::thread _renderThread;
+    std::atomic<bool> _isStopping{ false };
+    std::exception_ptr _renderError;
+    SnapshotBuffer<PreviewerSnapshot> _snapshots;
+
+    // Double-buffered RGBA8 frames: the render thread fills one while the UI may upload the other.
+    // _presentedFrameIndex is the newest completed frame, _uploadingFrameIndex the one the UI is reading (-1 for none).
+    std::vector<sf::Uint8> _frames[2];
+    std::atomic<int> _presentedFrameIndex{ -1 };
+    std::atomic<int> _uploadingFrameIndex{ -1 };
+    std::atomic<uint64_t> _completedFrameCount{ 0 };
+
+    // ---- UI thread only ----
+    size_t _currentMaterialIndex = 0;
+    std::vector<std::vector<float>> _materialValues; // Slider values per material, in GetPropertyDescriptors() order
+    std::vector<ArrayView<ShaderPropertyDescriptor>> _materialDescriptors;
+    std::vector<std::string> _materialNames;
+    std::vector<ShadingRate> _materialShadingRates;
+    int _sampleCount = 1;
+    PostProcessSettings _postProcess;
+    Light _light;
+    uint64_t _uploadedFrameCount = 0;
+
     sf::Font _font;
     std::vector<std::unique_ptr<Slider>> _sliders;
     sf::Text _shaderNameText;
     sf::Text _hintText;
+    bool _isUiDirty = true;
 
     void _UpdateShaderUI()
     {
         _sliders.clear();
 
-        Material* currentMat = _availableMaterials[_currentMaterialIndex].get();
-        IShaderProperties* props = currentMat->GetProperties();
-
         // Hint text update
         _hintText.setFont(_font);
         _hintText.setString("Press C for Changing Shader");
@@ -73,31 +113,28 @@ private:
 
         // Shader name update
         _shaderNameText.setFont(_font);
-        _shaderNameText.setString(props->GetShaderName());
+        _shaderNameText.setString(_materialNames[_currentMaterialIndex]);
         _shaderNameText.setCharacterSize(20);
         _shaderNameText.setFillColor(sf::Color::White);
         _shaderNameText.setPosition(20, 20);
 
         // Create sliders for properties
         float yPos = 80.0f;
-        const auto& sliderProps = props->GetSliderProperties();
         float rightSideX = SCREEN_WIDTH - 250.0f;
-        _CreateShaderPropertySliders(props, sliderProps, yPos);
+        _CreateShaderPropertySliders(_materialDescriptors[_currentMaterialIndex],
+            _materialValues[_currentMaterialIndex], yPos);
         _CreateLightControlSliders(rightSideX);
     }
 
-    void _CreateShaderPropertySliders(IShaderProperties* properties,
-        const std::map<std::string, std::pair<float, float>>& sliderProps,
+    void _CreateShaderPropertySliders(ArrayView<ShaderPropertyDescriptor> descriptors,
+        const std::vector<float>& values,
         float& yPos)
     {
-        for (const auto& prop : sliderProps)
+        for (size_t i = 0; i < descriptors.size(); ++i)
         {
-            const std::string& propName = prop.first;
-            const std::pair<float, float>& propRange = prop.second;
-            float initialValue = _GetInitialValueForProperty(properties, propName);
-
-            _sliders.emplace_back(std::make_unique<Slider>(_font, propName, propRange.first, propRange.second,
-                initialValue, sf::Vector2f(20, yPos)));
+            const ShaderPropertyDescriptor& descriptor = descriptors[i];
+            _sliders.emplace_back(std::make_unique<Slider>(_font, descriptor.name, descriptor.minValue,
+                descriptor.maxValue, values[i], sf::Vector2f(20, yPos)));
             yPos += 40.0f;
         }
     }
@@ -121,118 +158,146 @@ private:
             sf::Vector2f(rightSideX, rightYPos)));
     }
 
-    float _GetInitialValueForProperty(IShaderProperties* properties, const std::string& propName)
+    void _ReadSliderValues()
     {
-        if (auto blinnPhong = dynamic_cast<BlinnPhongProperties*>(properties))
+        std::vector<float>& values = _materialValues[_currentMaterialIndex];
+        for (size_t i = 0; i < values.size(); ++i)
         {
-            return _GetBlinnPhongInitialValue(blinnPhong, propName);
+            values[i] = _sliders[i]->GetValue();
         }
-        else if (auto toon = dynamic_cast<ToonProperties*>(properties))
-        {
-            return _GetToonInitialValue(toon, propName);
-        }
-        return 0.0f;
+
+        // Light sliders follow the shader sliders
+        size_t lightSliderIndex = values.size();
+        _light.position.x = _sliders[lightSliderIndex]->GetValue();
+        _light.position.y = _sliders[lightSliderIndex + 1]->GetValue();
+        _light.position.z = _sliders[lightSliderIndex + 2]->GetValue();
+        _light.color.x = _sliders[lightSliderIndex + 3]->GetValue();
+        _light.color.y = _sliders[lightSliderIndex + 4]->GetValue();
+        _light.color.z = _sliders[lightSliderIndex + 5]->GetValue();
     }
 
-    float _GetBlinnPhongInitialValue(BlinnPhongProperties* properties, const std::string& propName)
+    void _PublishSnapshot()
     {
-        switch (GetPropertyEnum(propName))
-        {
-        case BlinnPhongProperty::AmbientX_Red: return properties->ambient.x;
-        case BlinnPhongProperty::AmbientY_Green: return properties->ambient.y;
-        case BlinnPhongProperty::AmbientZ_Blue: return properties->ambient.z;
-        case BlinnPhongProperty::DiffuseX_Red: return properties->diffuse.x;
-        case BlinnPhongProperty::DiffuseY_Green: return properties->diffuse.y;
-        case BlinnPhongProperty::DiffuseZ_Blue: return properties->diffuse.z;
-        case BlinnPhongProperty::SpecularX_Red: return properties->specular.x;
-        case BlinnPhongProperty::SpecularY_Green: return properties->specular.y;
-        case BlinnPhongProperty::SpecularZ_Blue: return properties->specular.z;
-        case BlinnPhongProperty::Smoothness: return properties->smoothness;
-        }
-        return 0.0f;
+        PreviewerSnapshot& snapshot = _snapshots.GetWriteSlot();
+        snapshot.materialIndex = _currentMaterialIndex;
+        snapshot.shaderValues = _materialValues[_currentMaterialIndex];
+        snapshot.shadingRate = _materialShadingRates[_currentMaterialIndex];
+        snapshot.sampleCount = _sampleCount;
+        snapshot.postProcess = _postProcess;
+        snapshot.light = _light;
+        _snapshots.Publish();
     }
 
-    float _GetToonInitialValue(ToonProperties* properties, const std::string& propName)
+    // Render thread: copy the UI state into the scene and pipeline
+    void _ApplySnapshot(const PreviewerSnapshot& snapshot)
     {
-        switch (GetToonPropertyEnum(propName))
+        const std::shared_ptr<Material>& material = _availableMaterials[snapshot.materialIndex];
+        const std::shared_ptr<RenderableObject>& previewObject = _scene.Get(_previewObjectId);
+        if (previewObject->GetMaterial() != material)
+        {
+            previewObject->SetMaterial(material);
+        }
+        material->SetShadingRate(snapshot.shadingRate);
+
+        IShaderProperties* properties = material->GetProperties();
+        for (size_t i = 0; i < snapshot.shaderValues.size(); ++i)
         {
-        case ToonProperty::AmbientX_Red: return properties->ambient.x;
-        case ToonProperty::AmbientY_Green: return properties->ambient.y;
-        case ToonProperty::AmbientZ_Blue: return properties->ambient.z;
-        case ToonProperty::BaseColorX_Red: return properties->baseColor.x;
-        case ToonProperty::BaseColorY_Green: return properties->baseColor.y;
-        case ToonProperty::BaseColorZ_Blue: return properties->baseColor.z;
-        case ToonProperty::DiffuseSoftness: return properties->softness;
-        case ToonProperty::RimColorX_Red: return properties->rimColor.x;
-        case ToonProperty::RimColorY_Green: return properties->rimColor.y;
-        case ToonProperty::RimColorZ_Blue: return properties->rimColor.z;
-        case ToonProperty::RimWidth: return properties->rimWidth;
-        case ToonProperty::RimSoftness: return properties->rimSoftness;
-        case ToonProperty::RimDirection: return properties->rimDirection;
+            properties->SetProperty(i, snapshot.shaderValues[i]);
         }
-        return 0.0f;
+
+        _pipeline.SetLight(snapshot.light);
+        _pipeline.SetSampleCount(snapshot.sampleCount);
+        _pipeline.SetPostProcess(snapshot.postProcess);
     }
 
-    void _UpdateShaderProperties(IShaderProperties* properties,
-        const std::map<std::string, std::pair<float, float>>& sliderProps)
+    void _RenderLoop()
     {
-        size_t i = 0;
-        for (const auto& prop : sliderProps)
+        Profiler::SetThreadName("Render");
+        try
         {
-            const std::string& propName = prop.first;
-            float value = _sliders[i]->GetValue();
-
-            if (auto blinnPhong = dynamic_cast<BlinnPhongProperties*>(properties))
+            int targetFrameIndex = 0;
+            while (!_isStopping.load(std::memory_order_relaxed))
             {
-                switch (GetPropertyEnum(propName))
+                if (_snapshots.Acquire())
                 {
-                case BlinnPhongProperty::AmbientX_Red: blinnPhong->ambient.x = value; break;
-                case BlinnPhongProperty::AmbientY_Green: blinnPhong->ambient.y = value; break;
-                case BlinnPhongProperty::AmbientZ_Blue: blinnPhong->ambient.z = value; break;
-                case BlinnPhongProperty::DiffuseX_Red: blinnPhong->diffuse.x = value; break;
-                case BlinnPhongProperty::DiffuseY_Green: blinnPhong->diffuse.y = value; break;
-                case BlinnPhongProperty::DiffuseZ_Blue: blinnPhong->diffuse.z = value; break;
-                case BlinnPhongProperty::SpecularX_Red: blinnPhong->specular.x = value; break;
-                case BlinnPhongProperty::SpecularY_Green: blinnPhong->specular.y = value; break;
-                case BlinnPhongProperty::SpecularZ_Blue: blinnPhong->specular.z = value; break;
-                case BlinnPhongProperty::Smoothness: blinnPhong->smoothness = value; break;
+                    _ApplySnapshot(_snapshots.GetReadSlot());
                 }
-            }
-            else if (auto toon = dynamic_cast<ToonProperties*>(properties))
-            {
-                switch (GetToonPropertyEnum(propName))
+
+                if (!_RenderFrame(targetFrameIndex))
                 {
-                case ToonProperty::AmbientX_Red: toon->ambient.x = value; break;
-                case ToonProperty::AmbientY_Green: toon->ambient.y = value; break;
-                case ToonProperty::AmbientZ_Blue: toon->ambient.z = value; break;
-                case ToonProperty::BaseColorX_Red: toon->baseColor.x = value; break;
-                case ToonProperty::BaseColorY_Green: toon->baseColor.y = value; break;
-                case ToonProperty::BaseColorZ_Blue: toon->baseColor.z = value; break;
-                case ToonProperty::DiffuseSoftness: toon->softness = value; break;
-                case ToonProperty::RimColorX_Red: toon->rimColor.x = value; break;
-                case ToonProperty::RimColorY_Green: toon->rimColor.y = value; break;
-                case ToonProperty::RimColorZ_Blue: toon->rimColor.z = value; break;
-                case ToonProperty::RimWidth: toon->rimWidth = value; break;
-                case ToonProperty::RimSoftness: toon->rimSoftness = value; break;
-                case ToonProperty::RimDirection: toon->rimDirection = value; break;
+                    // Nothing changed, the UI keeps showing the last completed frame
+                    sf::sleep(sf::milliseconds(IDLE_SLEEP_MS));
+                    continue;
                 }
+                targetFrameIndex = 1 - targetFrameIndex;
             }
-            i++;
+        }
+        catch (...)
+        {
+            _renderError = std::current_exception();
+            _isStopping.store(true);
         }
     }
 
-    void _UpdateLightProperties(size_t shaderPropCount)
+    // Render thread: returns false when the last frame could be reused
+    bool _RenderFrame(int targetFrameIndex)
     {
-        // Get light data from UI
-        _light.position.x = _sliders[shaderPropCount]->GetValue();
-        _light.position.y = _sliders[shaderPropCount + 1]->GetValue();
-        _light.position.z = _sliders[shaderPropCount + 2]->GetValue();
-        _light.color.x = _sliders[shaderPropCount + 3]->GetValue();
-        _light.color.y = _sliders[shaderPropCount + 4]->GetValue();
-        _light.color.z = _sliders[shaderPropCount + 5]->GetValue();
-
-        // Sync light data to Pipeline
-        _pipeline.SetLight(_light);
+        // Describe this frame's draw list; the pipeline adds camera and light versions itself.
+        // Only visible objects are drawn, so changes to culled ones do not invalidate the frame.
+        _scene.QueryFrustum(_camera, _visibleObjects);
+        FrameHash sceneHash;
+        for (SceneObjectId id : _visibleObjects)
+        {
+            const std::shared_ptr<RenderableObject>& obj = _scene.Get(id);
+            sceneHash.Add(obj->GetVersion());
+            sceneHash.Add(obj->GetMesh()->GetVersion());
+            sceneHash.Add(obj->GetMaterial()->GetVersion());
+        }
+
+        // Clear the pipeline's internal buffers, or reuse the last frame if nothing changed
+        if (!_pipeline.BeginFrame(sceneHash.GetValue()))
+        {
+            return false;
+        }
+
+        PROFILE_SCOPE("Frame");
+
+        // Iterate through the visible part of the scene
+        for (SceneObjectId id : _visibleObjects)
+        {
+            const std::shared_ptr<RenderableObject>& obj = _scene.Get(id);
+            // Bind the material
+            _pipeline.BindMaterial(obj->GetMaterial().get());
+
+            // Execute the draw call
+            _pipeline.Draw(
+                *(obj->GetMesh()),
+                obj->GetPosition()
+            );
+        }
+        _pipeline.EndFrame();
+
+        // The UI may still be uploading the frame before last from this buffer
+        while (_uploadingFrameIndex.load() == targetFrameIndex)
+        {
+            std::this_thread::yield();
+        }
+
+        // Tonemap, encode and anti-alias straight into the RGBA frame
+        _pipeline.ResolveDisplayPixels(_frames[targetFrameIndex]);
+
+        _presentedFrameIndex.store(targetFrameIndex);
+        _completedFrameCount.fetch_add(1);
+        return true;
+    }
+
+    void _StopRenderThread()
+    {
+        _isStopping.store(true);
+        if (_renderThread.joinable())
+        {
+            _renderThread.join();
+        }
     }
 
 
@@ -242,9 +307,10 @@ public:
         _pipeline(SCREEN_WIDTH, SCREEN_HEIGHT)
     {
         // Create image buffers
-        _image.create(SCREEN_WIDTH, SCREEN_HEIGHT, sf::Color::Black);
         _texture.create(SCREEN_WIDTH, SCREEN_HEIGHT);
         _sprite.setTexture(_texture);
+        _frames[0].assign(static_cast<size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT * 4, 0);
+        _frames[1].assign(static_cast<size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT * 4, 0);
 
         // Create global uniforms
         _camera = Camera(
@@ -259,6 +325,12 @@ public:
         _pipeline.SetCamera(_camera);
         _pipeline.SetLight(_light);
 
+        // Slider edits only touch fragment shading, so the sphere's geometry can be reused across frames
+        _pipeline.SetVertexCacheBudget(VERTEX_CACHE_BUDGET_BYTES);
+
+        // Drop resolution rather than frames when the machine is busy
+        _pipeline.SetTargetFrameTime(TARGET_FRAME_MS);
+
         // Load UI resources
         if (!_font.loadFromFile("Assets/arial.ttf"))
         {
@@ -274,6 +346,21 @@ public:
         _availableMaterials.push_back(std::make_shared<Material>(_availableShaders[0]));
         _availableMaterials.push_back(std::make_shared<Material>(_availableShaders[1]));
 
+        // The UI keeps its own copy of every material's values, so only the render thread touches the materials
+        for (const auto& material : _availableMaterials)
+        {
+            IShaderProperties* props = material->GetProperties();
+            std::vector<float> values(props->GetPropertyCount());
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                values[i] = props->GetProperty(i);
+            }
+            _materialValues.push_back(std::move(values));
+            _materialDescriptors.push_back(props->GetPropertyDescriptors());
+            _materialNames.push_back(props->GetShaderName());
+            _materialShadingRates.push_back(material->GetShadingRate());
+        }
+
         // Create mesh (geometry)
         auto sphereMesh = MeshGenerator::CreateSphere(3.0f, 64, Vec3(0, 0, 0));
 
@@ -283,20 +370,35 @@ public:
             _availableMaterials[0],
             Vec3(0, 0, 0)
         );
-        _scene.push_back(sphereObject);
+        _previewObjectId = _scene.Add(sphereObject);
 
         // Initial UI setup
         _UpdateShaderUI();
     }
 
+    ~MaterialPreviewer()
+    {
+        _StopRenderThread();
+    }
+
     void Run()
     {
-        while (_window.isOpen())
+        _PublishSnapshot();
+        _renderThread = std::thread(&MaterialPreviewer::_RenderLoop, this);
+
+        // The UI loop never waits for a frame, it presents whichever frame completed last
+        while (_window.isOpen() && !_isStopping.load())
         {
             HandleEvents();
             Update();
             Render();
         }
+
+        _StopRenderThread();
+        if (_renderError)
+        {
+            std::rethrow_exception(_renderError);
+        }
     }
 
     void HandleEvents()
@@ -304,6 +406,8 @@ public:
         sf::Event event;
         while (_window.pollEvent(event))
         {
+            _isUiDirty = true;
+
             if (event.type == sf::Event::Closed)
             {
                 _window.close();
@@ -313,11 +417,52 @@ public:
             {
                 if (event.key.code == sf::Keyboard::C)
                 {
-                    // Switch shader
-                    _currentMaterialIndex = (_currentMaterialIndex + 1) % _availableMaterials.size();
-                    _scene[0]->SetMaterial(_availableMaterials[_currentMaterialIndex]);
+                    // Switch shader, keeping the slider values of the one we leave
+                    _ReadSliderValues();
+                    _currentMaterialIndex = (_currentMaterialIndex + 1) % _materialValues.size();
                     _UpdateShaderUI();
                 }
+                else if (event.key.code == sf::Keyboard::R)
+                {
+                    // Cycle the current material's shading rate: 1x1, 1x2, 2x2, 4x4
+                    static const char* rateNames[] = { "1x1", "1x2", "2x2", "4x4" };
+                    ShadingRate& rate = _materialShadingRates[_currentMaterialIndex];
+                    rate = static_cast<ShadingRate>((static_cast<int>(rate) + 1) % 4);
+                    std::cout << "Shading rate " << rateNames[static_cast<int>(rate)] << "\n";
+                }
+                else if (event.key.code == sf::Keyboard::M)
+                {
+                    // Toggle 4x MSAA
+                    _sampleCount = (_sampleCount == 1) ? FrameBuffer::MAX_SAMPLE_COUNT : 1;
+                    std::cout << "MSAA " << _sampleCount << "x\n";
+                }
+                else if (event.key.code == sf::Keyboard::O)
+                {
+                    // Cycle the tonemapper: clamp, filmic, ACES; the curves are shown sRGB-encoded
+                    static const char* tonemapperNames[] = { "Clamp", "Filmic", "ACES" };
+                    Tonemapper& tonemapper = _postProcess.tonemapper;
+                    tonemapper = static_cast<Tonemapper>((static_cast<int>(tonemapper) + 1) % 3);
+                    _postProcess.isSrgbEncoded = tonemapper != Tonemapper::Clamp;
+                    std::cout << "Tonemapper " << tonemapperNames[static_cast<int>(tonemapper)] << "\n";
+                }
+                else if (event.key.code == sf::Keyboard::F)
+                {
+                    // Toggle FXAA
+                    _postProcess.isFxaaEnabled = !_postProcess.isFxaaEnabled;
+                    std::cout << "FXAA " << (_postProcess.isFxaaEnabled ? "on" : "off") << "\n";
+                }
+                else if (event.key.code == sf::Keyboard::P)
+                {
+                    // Toggle trace recording
+                    Profiler::SetEnabled(!Profiler::IsEnabled());
+                    std::cout << "Profiler " << (Profiler::IsEnabled() ? "enabled" : "disabled") << "\n";
+                }
+                else if (event.key.code == sf::Keyboard::T)
+                {
+                    // Dump the recorded events, open the file in chrome://tracing or Perfetto
+                    Profiler::WriteChromeTrace(TRACE_OUTPUT_PATH);
+                    std::cout << "Trace written to " << TRACE_OUTPUT_PATH << "\n";
+                }
             }
 
             for (auto& slider : _sliders)
@@ -329,54 +474,47 @@ public:
 
     void Update()
     {
-        // Update properties from UI
-        Material* currentMat = _availableMaterials[_currentMaterialIndex].get();
-        IShaderProperties* props = currentMat->GetProperties();
-        auto sliderPropsMap = props->GetSliderProperties();
-
-        _UpdateShaderProperties(props, sliderPropsMap);
-        _UpdateLightProperties(sliderPropsMap.size());
+        // Hand the UI state to the render thread, which picks up the newest one before its next frame
+        if (_isUiDirty)
+        {
+            _ReadSliderValues();
+            _PublishSnapshot();
+        }
     }
 
     void Render()
     {
-        // ------------------------------------
-        // Bind/Draw Render Loop
-        // ------------------------------------
-
-        // Clear the pipeline's internal buffers
-        _pipeline.ClearBuffers();
-
-        // Iterate through the scene
-        for (const auto& obj : _scene)
+        uint64_t completedFrameCount = _completedFrameCount.load();
+        bool hasNewFrame = completedFrameCount != _uploadedFrameCount;
+        if (!hasNewFrame && !_isUiDirty)
         {
-            // Bind the material
-            _pipeline.BindMaterial(obj->GetMaterial().get());
-
-            // Execute the draw call
-            _pipeline.Draw(
-                *(obj->GetMesh()),
-                obj->GetPosition()
-            );
+            // Nothing to redraw, the window still shows the last presented frame
+            sf::sleep(sf::milliseconds(IDLE_SLEEP_MS));
+            return;
         }
 
-        // Blit the pipeline's Vec3 buffer to the SFML Image
-        const auto& colorBuffer = _pipeline.GetFinalColorBuffer();
-        for (int y = 0; y < _pipeline.GetHeight(); ++y)
+        if (hasNewFrame)
         {
-            for (int x = 0; x < _pipeline.GetWidth(); ++x)
+            // Claim the newest frame, then re-check that it is still the newest:
+            // once the claim is visible the render thread will not start overwriting that buffer
+            int frameIndex = _presentedFrameIndex.load();
+            for (;;)
             {
-                const Vec3& color = colorBuffer[y * _pipeline.GetWidth() + x];
-                // Simple tonemapping (Clamp)
-                sf::Uint8 r = static_cast<sf::Uint8>(std::min(color.x, 1.0f) * 255.0f);
-                sf::Uint8 g = static_cast<sf::Uint8>(std::min(color.y, 1.0f) * 255.0f);
-                sf::Uint8 b = static_cast<sf::Uint8>(std::min(color.z, 1.0f) * 255.0f);
-                _image.setPixel(x, y, sf::Color(r, g, b));
+                _uploadingFrameIndex.store(frameIndex);
+                int latestFrameIndex = _presentedFrameIndex.load();
+                if (latestFrameIndex == frameIndex)
+                {
+                    break;
+                }
+                frameIndex = latestFrameIndex;
             }
+            _texture.update(_frames[frameIndex].data());
+            _uploadingFrameIndex.store(-1);
+            _uploadedFrameCount = completedFrameCount;
         }
+        _isUiDirty = false;
 
         // Display to the window
-        _texture.update(_image);
         _window.clear(sf::Color::Black);
         _window.draw(_sprite);
 
@@ -396,6 +534,7 @@ int main()
 {
     try
     {
+        Profiler::SetThreadName("UI");
         MaterialPreviewer previewer;
         previewer.Run();
     }